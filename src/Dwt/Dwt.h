@@ -0,0 +1,83 @@
+/**@file
+ * This file is part of the ARM BSP for the Test Environment.
+ *
+ * @copyright 2020-2021 N7 Space Sp. z o.o.
+ *
+ * Test Environment was developed under a programme of,
+ * and funded by, the European Space Agency (the "ESA").
+ *
+ *
+ * Licensed under the ESA Public License (ESA-PL) Permissive,
+ * Version 2.3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://essr.esa.int/license/list
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/// \brief Header containing Data Watchpoint and Trace unit cycle counter
+/// functions, used for lightweight profiling of drivers.
+
+/**
+ * @defgroup Dwt Dwt
+ * @ingroup Bsp
+ * @{
+ */
+
+#ifndef BSP_DWT_H
+#define BSP_DWT_H
+
+#include "DwtRegisters.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/// \brief Enables the processor cycle counter.
+static inline void
+Dwt_enableCycleCounter(void)
+{
+	volatile uint32_t *const demcr = (volatile uint32_t *)DWT_DEMCR_ADDRESS;
+	volatile uint32_t *const lar = (volatile uint32_t *)DWT_LAR_ADDRESS;
+	volatile Dwt_Registers *const dwt =
+			(volatile Dwt_Registers *)DWT_BASE_ADDRESS;
+
+	*demcr |= DWT_DEMCR_TRCENA_MASK;
+	*lar = DWT_LAR_UNLOCK_KEY;
+	dwt->ctrl |= DWT_CTRL_CYCCNTENA_MASK;
+}
+
+/// \brief Returns whether the processor cycle counter is running.
+/// \returns Whether the cycle counter is enabled.
+static inline bool
+Dwt_isCycleCounterEnabled(void)
+{
+	const volatile uint32_t *const demcr =
+			(volatile uint32_t *)DWT_DEMCR_ADDRESS;
+	const volatile Dwt_Registers *const dwt =
+			(volatile Dwt_Registers *)DWT_BASE_ADDRESS;
+
+	return ((*demcr & DWT_DEMCR_TRCENA_MASK) != 0u)
+			&& ((dwt->ctrl & DWT_CTRL_CYCCNTENA_MASK) != 0u);
+}
+
+/// \brief Returns the current value of the processor cycle counter. The
+///        counter wraps around, so intervals shall be computed with unsigned
+///        subtraction.
+/// \returns Processor cycle count.
+static inline uint32_t
+Dwt_getCycleCount(void)
+{
+	const volatile Dwt_Registers *const dwt =
+			(volatile Dwt_Registers *)DWT_BASE_ADDRESS;
+	return dwt->cyccnt;
+}
+
+#endif // BSP_DWT_H
+
+/** @} */
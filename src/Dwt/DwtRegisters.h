@@ -0,0 +1,65 @@
+/**@file
+ * This file is part of the ARM BSP for the Test Environment.
+ *
+ * @copyright 2020-2021 N7 Space Sp. z o.o.
+ *
+ * Test Environment was developed under a programme of,
+ * and funded by, the European Space Agency (the "ESA").
+ *
+ *
+ * Licensed under the ESA Public License (ESA-PL) Permissive,
+ * Version 2.3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://essr.esa.int/license/list
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/// \brief Header containing Data Watchpoint and Trace unit specific register
+/// definitions.
+
+#ifndef BSP_DWT_REGISTERS_H
+#define BSP_DWT_REGISTERS_H
+
+#include <stdint.h>
+
+/// \brief Data Watchpoint and Trace unit registers.
+typedef struct {
+	volatile uint32_t ctrl; ///< 0xE0001000 Control Register
+	volatile uint32_t cyccnt; ///< 0xE0001004 Cycle Count Register
+	volatile uint32_t cpicnt; ///< 0xE0001008 CPI Count Register
+	volatile uint32_t
+			exccnt; ///< 0xE000100C Exception Overhead Count Register
+	volatile uint32_t sleepcnt; ///< 0xE0001010 Sleep Count Register
+	volatile uint32_t lsucnt; ///< 0xE0001014 LSU Count Register
+	volatile uint32_t foldcnt; ///< 0xE0001018 Folded-instruction Count Register
+	volatile uint32_t pcsr; ///< 0xE000101C Program Counter Sample Register
+} Dwt_Registers;
+
+/// \brief DWT base address.
+#define DWT_BASE_ADDRESS 0xE0001000u
+
+/// \brief DWT Lock Access Register address.
+#define DWT_LAR_ADDRESS 0xE0001FB0u
+/// \brief Key unlocking write access to the DWT registers.
+#define DWT_LAR_UNLOCK_KEY 0xC5ACCE55u
+
+/// \brief Debug Exception and Monitor Control Register address.
+#define DWT_DEMCR_ADDRESS 0xE000EDFCu
+/// \brief DEMCR trace enable bit mask.
+#define DWT_DEMCR_TRCENA_MASK 0x01000000u
+/// \brief DEMCR trace enable bit offset.
+#define DWT_DEMCR_TRCENA_OFFSET 24u
+
+/// \brief DWT CTRL cycle counter enable bit mask.
+#define DWT_CTRL_CYCCNTENA_MASK 0x00000001u
+/// \brief DWT CTRL cycle counter enable bit offset.
+#define DWT_CTRL_CYCCNTENA_OFFSET 0u
+
+#endif // BSP_DWT_REGISTERS_H
@@ -29,6 +29,8 @@
 
 #include <Utils/Utils.h>
 
+#define ELEMENT_MAX_DATA_SIZE 64u
+
 static bool
 verifyMcanId(const Mcan_Id id)
 {
@@ -405,13 +407,13 @@ setTxBuffer(Mcan *const mcan, const Mcan_Config *const config)
 				& MCAN_TXESC_TBDS_MASK);
 		mcan->txBufferAddress = config->txBuffer.startAddress;
 		mcan->txBufferSize = config->txBuffer.bufferSize;
+		mcan->txElementSize = decodeTxElementSizeInBytes(
+				config->txBuffer.elementSize);
 		mcan->txQueueAddress = config->txBuffer.startAddress
 				+ (((uint32_t)mcan->txElementSize
 						   * config->txBuffer.bufferSize)
 						/ sizeof(uint32_t));
 		mcan->txQueueSize = config->txBuffer.queueSize;
-		mcan->txElementSize = decodeTxElementSizeInBytes(
-				config->txBuffer.elementSize);
 	} else {
 		mcan->reg->txbc = 0;
 		mcan->reg->txesc = 0;
@@ -445,33 +447,39 @@ setTxEventFifo(Mcan *const mcan, const Mcan_Config *const config)
 	}
 }
 
+static void
+updateLineInterruptMasks(Mcan *const mcan)
+{
+	const uint32_t enableMask = mcan->reg->ie;
+	const uint32_t line1Mask = mcan->reg->ils;
+	mcan->lineInterruptMasks[Mcan_InterruptLine_0] = enableMask & ~line1Mask;
+	mcan->lineInterruptMasks[Mcan_InterruptLine_1] = enableMask & line1Mask;
+}
+
 static void
 setInterrupts(Mcan *const mcan, const Mcan_Config *const config)
 {
+	uint32_t enableMask = 0;
+	uint32_t line1Mask = 0;
 	for (uint32_t i = 0; i < (uint32_t)Mcan_Interrupt_Count; i++) {
-		if ((i == (uint32_t)Mcan_Interrupt_Reserved1)
-				|| (i == (uint32_t)Mcan_Interrupt_Reserved2))
+		const uint32_t mask = MCAN_INTERRUPT_MASK(i);
+		if ((mask & MCAN_INTERRUPT_MASK_ALL) == 0u)
 			continue;
-
-		uint32_t mask = 1u << i;
-		mcan->reg->ir = mask;
-
 		if (config->interrupts[i].isEnabled)
-			mcan->reg->ie |= mask;
-		else
-			mcan->reg->ie &= ~mask;
-
-		if (config->interrupts[i].line == Mcan_InterruptLine_0)
-			mcan->reg->ils &= ~mask;
-		else
-			mcan->reg->ils |= mask;
+			enableMask |= mask;
+		if (config->interrupts[i].line == Mcan_InterruptLine_1)
+			line1Mask |= mask;
 	}
+	mcan->reg->ir = MCAN_INTERRUPT_MASK_ALL;
+	Mcan_setInterruptMasks(mcan, enableMask, line1Mask);
+
 	mcan->reg->ile = 0;
 	if (config->isLine0InterruptEnabled)
 		mcan->reg->ile |= MCAN_ILE_EINT0_MASK;
 	if (config->isLine1InterruptEnabled)
 		mcan->reg->ile |= MCAN_ILE_EINT1_MASK;
 
+	mcan->txInterruptEnables = 0;
 	mcan->reg->txbtie = 0;
 	mcan->reg->txbcie = 0;
 }
@@ -861,53 +869,108 @@ decodeDataLengthCode(const uint8_t dlc, const bool isCanFdFrame)
 }
 
 static void
-txAddElement(Mcan *const mcan, const Mcan_TxElement element,
-		uint32_t *const baseAddress, const uint8_t index)
+encodeTxHeader(const Mcan_TxElement *const element, uint32_t *const header)
 {
-	memset(baseAddress, 0, mcan->txElementSize);
+	header[0] = 0;
+	header[1] = 0;
 
-	baseAddress[MCAN_TXELEMENT_ESI_WORD] |=
-			((uint32_t)element.esiFlag << MCAN_TXELEMENT_ESI_OFFSET)
+	header[MCAN_TXELEMENT_ESI_WORD] |=
+			((uint32_t)element->esiFlag << MCAN_TXELEMENT_ESI_OFFSET)
 			& MCAN_TXELEMENT_ESI_MASK;
-	baseAddress[MCAN_TXELEMENT_XTD_WORD] |=
-			((uint32_t)element.idType << MCAN_TXELEMENT_XTD_OFFSET)
+	header[MCAN_TXELEMENT_XTD_WORD] |=
+			((uint32_t)element->idType << MCAN_TXELEMENT_XTD_OFFSET)
 			& MCAN_TXELEMENT_XTD_MASK;
-	baseAddress[MCAN_TXELEMENT_RTR_WORD] |=
-			((uint32_t)element.frameType
+	header[MCAN_TXELEMENT_RTR_WORD] |=
+			((uint32_t)element->frameType
 					<< MCAN_TXELEMENT_RTR_OFFSET)
 			& MCAN_TXELEMENT_RTR_MASK;
-	baseAddress[MCAN_TXELEMENT_MM_WORD] |=
-			(uint32_t)(element.marker << MCAN_TXELEMENT_MM_OFFSET)
+	header[MCAN_TXELEMENT_MM_WORD] |=
+			(uint32_t)(element->marker << MCAN_TXELEMENT_MM_OFFSET)
 			& MCAN_TXELEMENT_MM_MASK;
 
-	if (element.idType == Mcan_IdType_Standard)
-		baseAddress[MCAN_TXELEMENT_STDID_WORD] |=
-				(element.id << MCAN_TXELEMENT_STDID_OFFSET)
+	if (element->idType == Mcan_IdType_Standard)
+		header[MCAN_TXELEMENT_STDID_WORD] |=
+				(element->id << MCAN_TXELEMENT_STDID_OFFSET)
 				& MCAN_TXELEMENT_STDID_MASK;
 	else
-		baseAddress[MCAN_TXELEMENT_EXTID_WORD] |=
-				(element.id << MCAN_TXELEMENT_EXTID_OFFSET)
+		header[MCAN_TXELEMENT_EXTID_WORD] |=
+				(element->id << MCAN_TXELEMENT_EXTID_OFFSET)
 				& MCAN_TXELEMENT_EXTID_MASK;
 
-	if (element.isTxEventStored)
-		baseAddress[MCAN_TXELEMENT_EFC_WORD] |= MCAN_TXELEMENT_EFC_MASK;
-	if (element.isCanFdFormatEnabled)
-		baseAddress[MCAN_TXELEMENT_FDF_WORD] |= MCAN_TXELEMENT_FDF_MASK;
-	if (element.isBitRateSwitchingEnabled)
-		baseAddress[MCAN_TXELEMENT_BRS_WORD] |= MCAN_TXELEMENT_BRS_MASK;
-	baseAddress[MCAN_TXELEMENT_DLC_WORD] |=
-			(uint32_t)(encodeDataLengthCode(element.dataSize)
+	if (element->isTxEventStored)
+		header[MCAN_TXELEMENT_EFC_WORD] |= MCAN_TXELEMENT_EFC_MASK;
+	if (element->isCanFdFormatEnabled)
+		header[MCAN_TXELEMENT_FDF_WORD] |= MCAN_TXELEMENT_FDF_MASK;
+	if (element->isBitRateSwitchingEnabled)
+		header[MCAN_TXELEMENT_BRS_WORD] |= MCAN_TXELEMENT_BRS_MASK;
+	header[MCAN_TXELEMENT_DLC_WORD] |=
+			(uint32_t)(encodeDataLengthCode(element->dataSize)
 					<< MCAN_TXELEMENT_DLC_OFFSET)
 			& MCAN_TXELEMENT_DLC_MASK;
+}
 
-	uint8_t *dataPointer =
-			(uint8_t *)&baseAddress[MCAN_TXELEMENT_DATA_WORD];
-	memcpy(dataPointer, element.data, element.dataSize);
+static void
+txWriteElementWords(uint32_t *const baseAddress, const uint32_t *const header,
+		const uint8_t *const data, const uint8_t dataSize)
+{
+	baseAddress[0] = header[0];
+	baseAddress[1] = header[1];
+	memcpy(&baseAddress[MCAN_TXELEMENT_DATA_WORD], data, dataSize);
+}
 
-	if (element.isInterruptEnabled)
-		mcan->reg->txbtie |= 1u << index;
-	else
-		mcan->reg->txbtie &= ~(1u << index);
+static void
+txWriteElement(const Mcan_TxElement *const element, uint32_t *const baseAddress)
+{
+	uint32_t header[2];
+	encodeTxHeader(element, header);
+	txWriteElementWords(baseAddress, header, element->data, element->dataSize);
+}
+
+static inline void
+memoryBarrier(void)
+{
+	asm volatile("dmb" ::: "memory");
+}
+
+/// \brief Updates the Tx Buffer Transmission Interrupt Enable register through
+///        its shadow copy, without masking interrupts. The shadow is updated
+///        atomically; a writer preempted between reading the shadow and
+///        writing the register stores a stale value, so the register is
+///        written until it matches the latest shadow.
+static void
+txUpdateInterruptEnables(Mcan *const mcan, const uint32_t clearMask,
+		const uint32_t setMask)
+{
+	uint32_t expected = __atomic_load_n(
+			&mcan->txInterruptEnables, __ATOMIC_RELAXED);
+	uint32_t desired;
+	do {
+		desired = (expected & ~clearMask) | setMask;
+		if (desired == expected)
+			return;
+	} while (!__atomic_compare_exchange_n(&mcan->txInterruptEnables,
+			&expected, desired, true, __ATOMIC_RELAXED,
+			__ATOMIC_RELAXED));
+
+	uint32_t value;
+	do {
+		value = __atomic_load_n(
+				&mcan->txInterruptEnables, __ATOMIC_RELAXED);
+		mcan->reg->txbtie = value;
+	} while (value
+			!= __atomic_load_n(&mcan->txInterruptEnables,
+					__ATOMIC_RELAXED));
+}
+
+static void
+txAddElement(Mcan *const mcan, const Mcan_TxElement element,
+		uint32_t *const baseAddress, const uint8_t index)
+{
+	txWriteElement(&element, baseAddress);
+
+	const uint32_t mask = 1u << index;
+	txUpdateInterruptEnables(
+			mcan, mask, element.isInterruptEnabled ? mask : 0u);
 }
 
 bool
@@ -945,39 +1008,294 @@ Mcan_txQueuePush(Mcan *const mcan, const Mcan_TxElement element,
 	return true;
 }
 
-bool
-Mcan_txBufferIsTransmissionFinished(const Mcan *const mcan, const uint8_t index)
+static uint32_t
+getTxQueueFreeMask(const Mcan *const mcan, uint8_t *const putIndex)
 {
-	return (mcan->reg->txbto & (1u << index)) != 0u;
+	const uint32_t sizeMask = (mcan->txQueueSize == 32u)
+			? UINT32_MAX
+			: (1u << mcan->txQueueSize) - 1u;
+	const uint32_t queueMask = sizeMask << mcan->txBufferSize;
+
+	if ((mcan->reg->txbc & MCAN_TXBC_TFQM_MASK) != 0u)
+		return queueMask & ~mcan->reg->txbrp;
+
+	const uint32_t status = mcan->reg->txfqs;
+	if ((status & MCAN_TXFQS_TFQF_MASK) != 0u)
+		return 0u;
+	const uint32_t freeLevel =
+			(status & MCAN_TXFQS_TFFL_MASK) >> MCAN_TXFQS_TFFL_OFFSET;
+	*putIndex = (uint8_t)((status & MCAN_TXFQS_TFQPI_MASK)
+			>> MCAN_TXFQS_TFQPI_OFFSET);
+	// Free FIFO elements follow the put index, wrapping within the queue.
+	const uint64_t freeMask = ((1ull << freeLevel) - 1u) << *putIndex;
+	return (uint32_t)(freeMask | (freeMask >> mcan->txQueueSize))
+			& queueMask;
 }
 
+static void
+txRequestTransmission(Mcan *const mcan, const uint32_t requestMask,
+		const uint32_t interruptMask)
+{
+	txUpdateInterruptEnables(mcan, requestMask, interruptMask);
+	mcan->reg->txbar = requestMask;
+}
+
+/// \brief Writes the i-th element of a batch into the given Tx buffer.
+/// \returns Whether the element has the transmission interrupt enabled.
+typedef bool (*TxBatchWriter)(const void *source, const uint32_t i,
+		uint32_t *const baseAddress);
+
 static bool
-isTxEventFifoEmpty(const Mcan *const mcan)
+txQueuePushBatch(Mcan *const mcan, const TxBatchWriter write,
+		const void *const source, const uint32_t count,
+		uint32_t *const pushedCount, int *const errCode)
 {
-	const uint8_t count = (mcan->reg->txefs & MCAN_TXEFS_EFFL_MASK)
-			>> MCAN_TXEFS_EFFL_OFFSET;
-	return count == 0u;
+	*pushedCount = 0;
+	if (count == 0u)
+		return true;
+
+	uint8_t index = 0;
+	uint32_t freeMask = getTxQueueFreeMask(mcan, &index);
+	if (freeMask == 0u)
+		return returnError(errCode, Mcan_ErrorCodes_TxFifoFull);
+	// In Tx Queue (ID) mode any free buffer can be used, starting from the
+	// lowest one.
+	if ((freeMask & (1u << index)) == 0u)
+		index = (uint8_t)__builtin_ctz(freeMask);
+
+	const uint8_t queueEnd = (uint8_t)(mcan->txBufferSize + mcan->txQueueSize);
+	uint32_t requestMask = 0;
+	uint32_t interruptMask = 0;
+	uint32_t pushed = 0;
+	while ((pushed < count) && (freeMask != 0u)) {
+		while ((freeMask & (1u << index)) == 0u) {
+			index++;
+			if (index != queueEnd)
+				continue;
+			index = mcan->txBufferSize;
+			// Requests added at once are put into the Tx FIFO in
+			// the order of buffer indexes, so the part preceding
+			// the wraparound has to be requested first.
+			if (requestMask != 0u)
+				txRequestTransmission(
+						mcan, requestMask, interruptMask);
+			requestMask = 0;
+			interruptMask = 0;
+		}
+		uint32_t *const baseAddr = mcan->txBufferAddress
+				+ ((uint32_t)(mcan->txElementSize * index)
+						/ sizeof(uint32_t));
+
+		const uint32_t mask = 1u << index;
+		if (write(source, pushed, baseAddr))
+			interruptMask |= mask;
+		requestMask |= mask;
+		freeMask &= ~mask;
+		pushed++;
+	}
+
+	txRequestTransmission(mcan, requestMask, interruptMask);
+	*pushedCount = pushed;
+
+	return true;
 }
 
-static const uint32_t *
-getTxEventFifoBaseAddress(const Mcan *const mcan)
+static bool
+txBatchWriteElement(const void *const source, const uint32_t i,
+		uint32_t *const baseAddress)
 {
-	const uint8_t getIndex = (mcan->reg->txefs & MCAN_TXEFS_EFGI_MASK)
-			>> MCAN_TXEFS_EFGI_OFFSET;
-	return mcan->txEventFifoAddress
-			+ ((uint32_t)(MCAN_TXEVENTELEMENT_SIZE * getIndex)
+	const Mcan_TxElement *const element =
+			&((const Mcan_TxElement *)source)[i];
+	txWriteElement(element, baseAddress);
+	return element->isInterruptEnabled;
+}
+
+bool
+Mcan_txQueuePushBatch(Mcan *const mcan, const Mcan_TxElement *const elements,
+		const uint32_t count, uint32_t *const pushedCount,
+		int *const errCode)
+{
+	assert(mcan != NULL);
+	assert(pushedCount != NULL);
+
+	return txQueuePushBatch(mcan, txBatchWriteElement, elements, count,
+			pushedCount, errCode);
+}
+
+void
+Mcan_txTemplatePrepare(
+		const Mcan_TxElement *const element, Mcan_TxTemplate *const tmpl)
+{
+	encodeTxHeader(element, tmpl->header);
+	tmpl->dataSize = element->dataSize;
+	tmpl->isInterruptEnabled = element->isInterruptEnabled;
+}
+
+static void
+txAddTemplate(Mcan *const mcan, const Mcan_TxTemplate *const tmpl,
+		const uint8_t *const data, const uint8_t index)
+{
+	uint32_t *const baseAddr = mcan->txBufferAddress
+			+ ((uint32_t)(mcan->txElementSize * index)
 					/ sizeof(uint32_t));
+	txWriteElementWords(baseAddr, tmpl->header, data, tmpl->dataSize);
+
+	const uint32_t mask = 1u << index;
+	txUpdateInterruptEnables(
+			mcan, mask, tmpl->isInterruptEnabled ? mask : 0u);
+	mcan->reg->txbar = mask;
 }
 
 bool
-Mcan_txEventFifoPull(Mcan *const mcan, Mcan_TxEventElement *const element,
+Mcan_txBufferAddTemplate(Mcan *const mcan, const Mcan_TxTemplate *const tmpl,
+		const uint8_t *const data, const uint8_t index,
 		int *const errCode)
 {
-	if (isTxEventFifoEmpty(mcan))
-		return returnError(errCode, Mcan_ErrorCodes_TxEventFifoEmpty);
+	if (index >= mcan->txBufferSize)
+		return returnError(errCode, Mcan_ErrorCodes_IndexOutOfRange);
+
+	txAddTemplate(mcan, tmpl, data, index);
+	return true;
+}
+
+bool
+Mcan_txQueuePushTemplate(Mcan *const mcan, const Mcan_TxTemplate *const tmpl,
+		const uint8_t *const data, uint8_t *const index,
+		int *const errCode)
+{
+	const uint32_t status = mcan->reg->txfqs;
+	if ((status & MCAN_TXFQS_TFQF_MASK) != 0u)
+		return returnError(errCode, Mcan_ErrorCodes_TxFifoFull);
+	*index = (uint8_t)((status & MCAN_TXFQS_TFQPI_MASK)
+			>> MCAN_TXFQS_TFQPI_OFFSET);
+
+	txAddTemplate(mcan, tmpl, data, *index);
+	return true;
+}
+
+typedef struct {
+	const Mcan_TxTemplate *templates;
+	const uint8_t *const *data;
+} TxTemplateBatch;
+
+static bool
+txBatchWriteTemplate(const void *const source, const uint32_t i,
+		uint32_t *const baseAddress)
+{
+	const TxTemplateBatch *const batch = (const TxTemplateBatch *)source;
+	const Mcan_TxTemplate *const tmpl = &batch->templates[i];
+	txWriteElementWords(baseAddress, tmpl->header, batch->data[i],
+			tmpl->dataSize);
+	return tmpl->isInterruptEnabled;
+}
+
+bool
+Mcan_txQueuePushTemplateBatch(Mcan *const mcan,
+		const Mcan_TxTemplate *const templates,
+		const uint8_t *const *const data, const uint32_t count,
+		uint32_t *const pushedCount, int *const errCode)
+{
+	assert(mcan != NULL);
+	assert(pushedCount != NULL);
+
+	const TxTemplateBatch batch = { .templates = templates, .data = data };
+	return txQueuePushBatch(mcan, txBatchWriteTemplate, &batch, count,
+			pushedCount, errCode);
+}
+
+/// \brief Reserves a free buffer from the mask. The reservation is taken
+///        before checking the pending requests, so a buffer requested by a
+///        preempting context in the meantime is never reused.
+static bool
+txReserveBuffer(Mcan *const mcan, const uint32_t bufferMask,
+		uint32_t *const reservedMask)
+{
+	uint32_t reserved = __atomic_load_n(
+			&mcan->txReservedBuffers, __ATOMIC_RELAXED);
+	for (;;) {
+		const uint32_t candidates =
+				bufferMask & ~reserved & ~mcan->reg->txbrp;
+		if (candidates == 0u)
+			return false;
+		const uint32_t mask = candidates & (~candidates + 1u);
+		if (!__atomic_compare_exchange_n(&mcan->txReservedBuffers,
+				    &reserved, reserved | mask, true,
+				    __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+			continue;
+		if ((mcan->reg->txbrp & mask) == 0u) {
+			*reservedMask = mask;
+			return true;
+		}
+		reserved = __atomic_and_fetch(&mcan->txReservedBuffers, ~mask,
+				__ATOMIC_RELEASE);
+	}
+}
+
+static void
+txSubmitReserved(Mcan *const mcan, const uint32_t mask,
+		const bool isInterruptEnabled)
+{
+	txUpdateInterruptEnables(mcan, mask, isInterruptEnabled ? mask : 0u);
+	memoryBarrier();
+	mcan->reg->txbar = mask;
+	// The pending request now protects the buffer until it is sent.
+	__atomic_fetch_and(&mcan->txReservedBuffers, ~mask, __ATOMIC_RELEASE);
+}
+
+bool
+Mcan_txSubmit(Mcan *const mcan, const Mcan_TxElement *const element,
+		const uint32_t bufferMask, uint8_t *const index,
+		int *const errCode)
+{
+	uint32_t mask = 0;
+	if (!txReserveBuffer(mcan, bufferMask, &mask))
+		return returnError(errCode, Mcan_ErrorCodes_TxFifoFull);
+
+	*index = (uint8_t)__builtin_ctz(mask);
+	uint32_t *const baseAddr = mcan->txBufferAddress
+			+ ((uint32_t)(mcan->txElementSize * (*index))
+					/ sizeof(uint32_t));
+	txWriteElement(element, baseAddr);
+	txSubmitReserved(mcan, mask, element->isInterruptEnabled);
+	return true;
+}
+
+bool
+Mcan_txSubmitTemplate(Mcan *const mcan, const Mcan_TxTemplate *const tmpl,
+		const uint8_t *const data, const uint32_t bufferMask,
+		uint8_t *const index, int *const errCode)
+{
+	uint32_t mask = 0;
+	if (!txReserveBuffer(mcan, bufferMask, &mask))
+		return returnError(errCode, Mcan_ErrorCodes_TxFifoFull);
+
+	*index = (uint8_t)__builtin_ctz(mask);
+	uint32_t *const baseAddr = mcan->txBufferAddress
+			+ ((uint32_t)(mcan->txElementSize * (*index))
+					/ sizeof(uint32_t));
+	txWriteElementWords(baseAddr, tmpl->header, data, tmpl->dataSize);
+	txSubmitReserved(mcan, mask, tmpl->isInterruptEnabled);
+	return true;
+}
 
-	const uint32_t *baseAddr = getTxEventFifoBaseAddress(mcan);
+bool
+Mcan_txBufferIsTransmissionFinished(const Mcan *const mcan, const uint8_t index)
+{
+	return (mcan->reg->txbto & (1u << index)) != 0u;
+}
+
+static bool
+isTxEventFifoEmpty(const Mcan *const mcan)
+{
+	const uint8_t count = (mcan->reg->txefs & MCAN_TXEFS_EFFL_MASK)
+			>> MCAN_TXEFS_EFFL_OFFSET;
+	return count == 0u;
+}
 
+static void
+getTxEventElement(const uint32_t *const baseAddr,
+		Mcan_TxEventElement *const element)
+{
 	element->esiFlag = (baseAddr[MCAN_TXEVENTELEMENT_ESI_WORD]
 					   & MCAN_TXEVENTELEMENT_ESI_MASK)
 			>> MCAN_TXEVENTELEMENT_ESI_OFFSET;
@@ -1018,6 +1336,55 @@ Mcan_txEventFifoPull(Mcan *const mcan, Mcan_TxEventElement *const element,
 					& MCAN_TXEVENTELEMENT_DLC_MASK)
 					>> MCAN_TXEVENTELEMENT_DLC_OFFSET,
 			element->isCanFdFormatEnabled);
+}
+
+bool
+Mcan_txEventFifoPull(Mcan *const mcan, Mcan_TxEventElement *const element,
+		int *const errCode)
+{
+	if (isTxEventFifoEmpty(mcan))
+		return returnError(errCode, Mcan_ErrorCodes_TxEventFifoEmpty);
+
+	const uint8_t getIndex = (mcan->reg->txefs & MCAN_TXEFS_EFGI_MASK)
+			>> MCAN_TXEFS_EFGI_OFFSET;
+	const uint32_t *baseAddr = mcan->txEventFifoAddress
+			+ ((uint32_t)(MCAN_TXEVENTELEMENT_SIZE * getIndex)
+					/ sizeof(uint32_t));
+
+	getTxEventElement(baseAddr, element);
+	mcan->reg->txefa = (uint32_t)(getIndex << MCAN_TXEFA_EFAI_OFFSET)
+			& MCAN_TXEFA_EFAI_MASK;
+	return true;
+}
+
+bool
+Mcan_txEventFifoPullBatch(Mcan *const mcan,
+		Mcan_TxEventElement *const elements, const uint32_t maxCount,
+		uint32_t *const pulledCount, int *const errCode)
+{
+	assert(mcan != NULL);
+	assert(pulledCount != NULL);
+
+	const uint32_t status = mcan->reg->txefs;
+	const uint32_t fillLevel =
+			(status & MCAN_TXEFS_EFFL_MASK) >> MCAN_TXEFS_EFFL_OFFSET;
+	const uint32_t count = fillLevel < maxCount ? fillLevel : maxCount;
+	*pulledCount = count;
+	if (count == 0u)
+		return returnError(errCode, Mcan_ErrorCodes_TxEventFifoEmpty);
+
+	uint8_t index = (uint8_t)((status & MCAN_TXEFS_EFGI_MASK)
+			>> MCAN_TXEFS_EFGI_OFFSET);
+	for (uint32_t i = 0; i < count; i++) {
+		if (i != 0u)
+			index = (uint8_t)((index + 1u) % mcan->txEventFifoSize);
+		const uint32_t *const baseAddr = mcan->txEventFifoAddress
+				+ ((uint32_t)(MCAN_TXEVENTELEMENT_SIZE * index)
+						/ sizeof(uint32_t));
+		getTxEventElement(baseAddr, &elements[i]);
+	}
+	mcan->reg->txefa = (uint32_t)(index << MCAN_TXEFA_EFAI_OFFSET)
+			& MCAN_TXEFA_EFAI_MASK;
 	return true;
 }
 
@@ -1080,6 +1447,47 @@ Mcan_rxBufferGet(Mcan *const mcan, const uint8_t index,
 	getRxElement(bufferPointer, element);
 }
 
+void
+Mcan_setRxBufferHandler(Mcan *const mcan, const Mcan_RxBufferHandler handler)
+{
+	mcan->rxBufferHandler = handler;
+}
+
+static void
+rxBufferScanFlags(Mcan *const mcan, uint32_t flags, const uint8_t firstIndex)
+{
+	uint8_t data[ELEMENT_MAX_DATA_SIZE];
+	Mcan_RxElement element;
+	element.data = data;
+	while (flags != 0u) {
+		const uint8_t index =
+				(uint8_t)(firstIndex + __builtin_ctz(flags));
+		flags &= flags - 1u;
+		Mcan_rxBufferGet(mcan, index, &element);
+		mcan->rxBufferHandler.callback(
+				index, &element, mcan->rxBufferHandler.arg);
+	}
+}
+
+uint32_t
+Mcan_rxBufferScan(Mcan *const mcan)
+{
+	assert(mcan->rxBufferHandler.callback != NULL);
+
+	const uint32_t newData1 = mcan->reg->ndat1;
+	const uint32_t newData2 = mcan->reg->ndat2;
+	if (newData1 != 0u) {
+		rxBufferScanFlags(mcan, newData1, 0u);
+		mcan->reg->ndat1 = newData1;
+	}
+	if (newData2 != 0u) {
+		rxBufferScanFlags(mcan, newData2, 32u);
+		mcan->reg->ndat2 = newData2;
+	}
+	return (uint32_t)(__builtin_popcount(newData1)
+			+ __builtin_popcount(newData2));
+}
+
 static bool
 rx0FifoPull(Mcan *const mcan, Mcan_RxElement *const element, int *const errCode)
 {
@@ -1128,6 +1536,207 @@ Mcan_rxFifoPull(Mcan *const mcan, const Mcan_RxFifoId id,
 	return returnError(errCode, Mcan_ErrorCodes_InvalidRxFifoId);
 }
 
+static uint8_t
+rxFifoPullBatch(const uint32_t *const fifoAddress, const uint8_t fifoSize,
+		const uint8_t elementSize, const uint8_t getIndex,
+		const uint32_t count, Mcan_RxElement *const elements)
+{
+	uint8_t index = getIndex;
+	for (uint32_t i = 0; i < count; i++) {
+		if (i != 0u)
+			index = (uint8_t)((index + 1u) % fifoSize);
+		const uint32_t *const baseAddr = fifoAddress
+				+ ((uint32_t)(elementSize * index)
+						/ sizeof(uint32_t));
+		getRxElement(baseAddr, &elements[i]);
+	}
+	return index;
+}
+
+static bool
+rx0FifoPullBatch(Mcan *const mcan, Mcan_RxElement *const elements,
+		const uint32_t maxCount, uint32_t *const pulledCount,
+		int *const errCode)
+{
+	const uint32_t status = mcan->reg->rxf0s;
+	const uint32_t fillLevel =
+			(status & MCAN_RXF0S_F0FL_MASK) >> MCAN_RXF0S_F0FL_OFFSET;
+	const uint32_t count = fillLevel < maxCount ? fillLevel : maxCount;
+	*pulledCount = count;
+	if (count == 0u)
+		return returnError(errCode, Mcan_ErrorCodes_RxFifoEmpty);
+	const uint8_t getIndex = (uint8_t)((status & MCAN_RXF0S_F0GI_MASK)
+			>> MCAN_RXF0S_F0GI_OFFSET);
+	const uint8_t lastIndex = rxFifoPullBatch(mcan->rxFifo0Address,
+			mcan->rxFifo0Size, mcan->rxFifo0ElementSize, getIndex,
+			count, elements);
+	mcan->reg->rxf0a = (uint32_t)(lastIndex << MCAN_RXF0A_F0AI_OFFSET)
+			& MCAN_RXF0A_F0AI_MASK;
+	return true;
+}
+
+static bool
+rx1FifoPullBatch(Mcan *const mcan, Mcan_RxElement *const elements,
+		const uint32_t maxCount, uint32_t *const pulledCount,
+		int *const errCode)
+{
+	const uint32_t status = mcan->reg->rxf1s;
+	const uint32_t fillLevel =
+			(status & MCAN_RXF1S_F1FL_MASK) >> MCAN_RXF1S_F1FL_OFFSET;
+	const uint32_t count = fillLevel < maxCount ? fillLevel : maxCount;
+	*pulledCount = count;
+	if (count == 0u)
+		return returnError(errCode, Mcan_ErrorCodes_RxFifoEmpty);
+	const uint8_t getIndex = (uint8_t)((status & MCAN_RXF1S_F1GI_MASK)
+			>> MCAN_RXF1S_F1GI_OFFSET);
+	const uint8_t lastIndex = rxFifoPullBatch(mcan->rxFifo1Address,
+			mcan->rxFifo1Size, mcan->rxFifo1ElementSize, getIndex,
+			count, elements);
+	mcan->reg->rxf1a = (uint32_t)(lastIndex << MCAN_RXF1A_F1AI_OFFSET)
+			& MCAN_RXF1A_F1AI_MASK;
+	return true;
+}
+
+bool
+Mcan_rxFifoPullBatch(Mcan *const mcan, const Mcan_RxFifoId id,
+		Mcan_RxElement *const elements, const uint32_t maxCount,
+		uint32_t *const pulledCount, int *const errCode)
+{
+	assert(mcan != NULL);
+	assert(pulledCount != NULL);
+	switch (id) {
+	case Mcan_RxFifoId_0:
+		return rx0FifoPullBatch(
+				mcan, elements, maxCount, pulledCount, errCode);
+	case Mcan_RxFifoId_1:
+		return rx1FifoPullBatch(
+				mcan, elements, maxCount, pulledCount, errCode);
+	}
+	*pulledCount = 0;
+	return returnError(errCode, Mcan_ErrorCodes_InvalidRxFifoId);
+}
+
+bool
+Mcan_rxFifoPeek(const Mcan *const mcan, const Mcan_RxFifoId id,
+		Mcan_RxElementView *const view, int *const errCode)
+{
+	assert(mcan != NULL);
+	uint32_t status;
+	switch (id) {
+	case Mcan_RxFifoId_0:
+		status = mcan->reg->rxf0s;
+		if ((status & MCAN_RXF0S_F0FL_MASK) == 0u)
+			return returnError(errCode, Mcan_ErrorCodes_RxFifoEmpty);
+		view->index = (uint8_t)((status & MCAN_RXF0S_F0GI_MASK)
+				>> MCAN_RXF0S_F0GI_OFFSET);
+		view->address = mcan->rxFifo0Address
+				+ ((uint32_t)(mcan->rxFifo0ElementSize
+						   * view->index)
+						/ sizeof(uint32_t));
+		view->fifoId = id;
+		return true;
+	case Mcan_RxFifoId_1:
+		status = mcan->reg->rxf1s;
+		if ((status & MCAN_RXF1S_F1FL_MASK) == 0u)
+			return returnError(errCode, Mcan_ErrorCodes_RxFifoEmpty);
+		view->index = (uint8_t)((status & MCAN_RXF1S_F1GI_MASK)
+				>> MCAN_RXF1S_F1GI_OFFSET);
+		view->address = mcan->rxFifo1Address
+				+ ((uint32_t)(mcan->rxFifo1ElementSize
+						   * view->index)
+						/ sizeof(uint32_t));
+		view->fifoId = id;
+		return true;
+	}
+	return returnError(errCode, Mcan_ErrorCodes_InvalidRxFifoId);
+}
+
+static void
+rxFifoPeekBatch(const uint32_t *const fifoAddress, const uint8_t fifoSize,
+		const uint32_t elementSize, const Mcan_RxFifoId id,
+		const uint8_t getIndex, const uint32_t count,
+		Mcan_RxElementView *const views)
+{
+	uint8_t index = getIndex;
+	for (uint32_t i = 0; i < count; i++) {
+		views[i].address = fifoAddress
+				+ ((elementSize * index) / sizeof(uint32_t));
+		views[i].fifoId = id;
+		views[i].index = index;
+		index++;
+		if (index == fifoSize)
+			index = 0;
+	}
+}
+
+bool
+Mcan_rxFifoPeekBatch(const Mcan *const mcan, const Mcan_RxFifoId id,
+		Mcan_RxElementView *const views, const uint32_t maxCount,
+		uint32_t *const peekedCount, int *const errCode)
+{
+	assert(mcan != NULL);
+	assert(peekedCount != NULL);
+
+	*peekedCount = 0;
+	uint32_t status;
+	uint32_t fillLevel;
+	uint8_t getIndex;
+	switch (id) {
+	case Mcan_RxFifoId_0:
+		status = mcan->reg->rxf0s;
+		fillLevel = (status & MCAN_RXF0S_F0FL_MASK)
+				>> MCAN_RXF0S_F0FL_OFFSET;
+		getIndex = (uint8_t)((status & MCAN_RXF0S_F0GI_MASK)
+				>> MCAN_RXF0S_F0GI_OFFSET);
+		break;
+	case Mcan_RxFifoId_1:
+		status = mcan->reg->rxf1s;
+		fillLevel = (status & MCAN_RXF1S_F1FL_MASK)
+				>> MCAN_RXF1S_F1FL_OFFSET;
+		getIndex = (uint8_t)((status & MCAN_RXF1S_F1GI_MASK)
+				>> MCAN_RXF1S_F1GI_OFFSET);
+		break;
+	default: return returnError(errCode, Mcan_ErrorCodes_InvalidRxFifoId);
+	}
+
+	const uint32_t count = fillLevel < maxCount ? fillLevel : maxCount;
+	if (count == 0u)
+		return returnError(errCode, Mcan_ErrorCodes_RxFifoEmpty);
+
+	if (id == Mcan_RxFifoId_0)
+		rxFifoPeekBatch(mcan->rxFifo0Address, mcan->rxFifo0Size,
+				mcan->rxFifo0ElementSize, id, getIndex, count,
+				views);
+	else
+		rxFifoPeekBatch(mcan->rxFifo1Address, mcan->rxFifo1Size,
+				mcan->rxFifo1ElementSize, id, getIndex, count,
+				views);
+	*peekedCount = count;
+	return true;
+}
+
+void
+Mcan_rxFifoRelease(Mcan *const mcan, const Mcan_RxElementView *const view)
+{
+	if (view->fifoId == Mcan_RxFifoId_0)
+		mcan->reg->rxf0a = (uint32_t)(view->index
+						      << MCAN_RXF0A_F0AI_OFFSET)
+				& MCAN_RXF0A_F0AI_MASK;
+	else
+		mcan->reg->rxf1a = (uint32_t)(view->index
+						      << MCAN_RXF1A_F1AI_OFFSET)
+				& MCAN_RXF1A_F1AI_MASK;
+}
+
+uint8_t
+Mcan_rxViewGetDataSize(const Mcan_RxElementView *const view)
+{
+	const uint32_t word = view->address[MCAN_RXELEMENT_DLC_WORD];
+	return decodeDataLengthCode((uint8_t)((word & MCAN_RXELEMENT_DLC_MASK)
+						    >> MCAN_RXELEMENT_DLC_OFFSET),
+			(word & MCAN_RXELEMENT_FDF_MASK) != 0u);
+}
+
 bool
 Mcan_getRxFifoStatus(const Mcan *const mcan, const Mcan_RxFifoId id,
 		Mcan_RxFifoStatus *const status, int *const errCode)
@@ -1276,3 +1885,62 @@ Mcan_isTxFifoEmpty(const Mcan *const mcan)
 			>> MCAN_TXBC_TFQS_OFFSET;
 	return freeLevel == queueSize;
 }
+
+static const uint32_t interruptGroupMasks[Mcan_InterruptGroup_Count] = {
+	[Mcan_InterruptGroup_RxFifo0] = MCAN_INTERRUPT_MASK_RX_FIFO0,
+	[Mcan_InterruptGroup_RxFifo1] = MCAN_INTERRUPT_MASK_RX_FIFO1,
+	[Mcan_InterruptGroup_TxComplete] = MCAN_INTERRUPT_MASK_TX_COMPLETE,
+	[Mcan_InterruptGroup_TxEvent] = MCAN_INTERRUPT_MASK_TX_EVENT,
+	[Mcan_InterruptGroup_Error] = MCAN_INTERRUPT_MASK_ERROR,
+	[Mcan_InterruptGroup_Other] = MCAN_INTERRUPT_MASK_OTHER,
+};
+
+void
+Mcan_setInterruptMasks(Mcan *const mcan, const uint32_t enableMask,
+		const uint32_t line1Mask)
+{
+	mcan->reg->ils = line1Mask & MCAN_INTERRUPT_MASK_ALL;
+	mcan->reg->ie = enableMask & MCAN_INTERRUPT_MASK_ALL;
+	updateLineInterruptMasks(mcan);
+}
+
+void
+Mcan_enableInterrupts(Mcan *const mcan, const uint32_t mask)
+{
+	mcan->reg->ie |= mask & MCAN_INTERRUPT_MASK_ALL;
+	updateLineInterruptMasks(mcan);
+}
+
+void
+Mcan_disableInterrupts(Mcan *const mcan, const uint32_t mask)
+{
+	mcan->reg->ie &= ~mask;
+	updateLineInterruptMasks(mcan);
+}
+
+void
+Mcan_setInterruptHandler(Mcan *const mcan, const Mcan_InterruptGroup group,
+		const Mcan_InterruptHandler handler)
+{
+	assert(group < Mcan_InterruptGroup_Count);
+	mcan->interruptHandlers[group] = handler;
+}
+
+void
+Mcan_handleInterrupt(Mcan *const mcan, const Mcan_InterruptLine line)
+{
+	const uint32_t flags = mcan->reg->ir & mcan->lineInterruptMasks[line];
+	mcan->reg->ir = flags;
+
+	if (((flags & MCAN_IR_DRX_MASK) != 0u)
+			&& (mcan->rxBufferHandler.callback != NULL))
+		(void)Mcan_rxBufferScan(mcan);
+
+	for (uint32_t i = 0; i < (uint32_t)Mcan_InterruptGroup_Count; i++) {
+		const uint32_t groupFlags = flags & interruptGroupMasks[i];
+		const Mcan_InterruptHandler *const handler =
+				&mcan->interruptHandlers[i];
+		if ((groupFlags != 0u) && (handler->callback != NULL))
+			handler->callback(groupFlags, handler->arg);
+	}
+}
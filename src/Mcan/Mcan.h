@@ -254,6 +254,89 @@ typedef enum {
 			30, ///< Number of interrupts including reserved indices.
 } Mcan_Interrupt;
 
+/// \brief Returns the mask of an MCAN interrupt source, as used by the
+///        raw interrupt register API (IR, IE and ILS bits).
+#define MCAN_INTERRUPT_MASK(interrupt) (1u << (uint32_t)(interrupt))
+
+/// \brief Named masks of MCAN interrupt sources.
+#define MCAN_INTERRUPT_MASK_RF0N MCAN_INTERRUPT_MASK(Mcan_Interrupt_Rf0n)
+#define MCAN_INTERRUPT_MASK_RF0W MCAN_INTERRUPT_MASK(Mcan_Interrupt_Rf0w)
+#define MCAN_INTERRUPT_MASK_RF0F MCAN_INTERRUPT_MASK(Mcan_Interrupt_Rf0f)
+#define MCAN_INTERRUPT_MASK_RF0L MCAN_INTERRUPT_MASK(Mcan_Interrupt_Rf0l)
+#define MCAN_INTERRUPT_MASK_RF1N MCAN_INTERRUPT_MASK(Mcan_Interrupt_Rf1n)
+#define MCAN_INTERRUPT_MASK_RF1W MCAN_INTERRUPT_MASK(Mcan_Interrupt_Rf1w)
+#define MCAN_INTERRUPT_MASK_RF1F MCAN_INTERRUPT_MASK(Mcan_Interrupt_Rf1f)
+#define MCAN_INTERRUPT_MASK_RF1L MCAN_INTERRUPT_MASK(Mcan_Interrupt_Rf1l)
+#define MCAN_INTERRUPT_MASK_HPM MCAN_INTERRUPT_MASK(Mcan_Interrupt_Hpm)
+#define MCAN_INTERRUPT_MASK_TC MCAN_INTERRUPT_MASK(Mcan_Interrupt_Tc)
+#define MCAN_INTERRUPT_MASK_TCF MCAN_INTERRUPT_MASK(Mcan_Interrupt_Tcf)
+#define MCAN_INTERRUPT_MASK_TFE MCAN_INTERRUPT_MASK(Mcan_Interrupt_Tfe)
+#define MCAN_INTERRUPT_MASK_TEFN MCAN_INTERRUPT_MASK(Mcan_Interrupt_Tefn)
+#define MCAN_INTERRUPT_MASK_TEFW MCAN_INTERRUPT_MASK(Mcan_Interrupt_Tefw)
+#define MCAN_INTERRUPT_MASK_TEFF MCAN_INTERRUPT_MASK(Mcan_Interrupt_Teff)
+#define MCAN_INTERRUPT_MASK_TEFL MCAN_INTERRUPT_MASK(Mcan_Interrupt_Tefl)
+#define MCAN_INTERRUPT_MASK_TSW MCAN_INTERRUPT_MASK(Mcan_Interrupt_Tsw)
+#define MCAN_INTERRUPT_MASK_MRAF MCAN_INTERRUPT_MASK(Mcan_Interrupt_Mraf)
+#define MCAN_INTERRUPT_MASK_TOO MCAN_INTERRUPT_MASK(Mcan_Interrupt_Too)
+#define MCAN_INTERRUPT_MASK_DRX MCAN_INTERRUPT_MASK(Mcan_Interrupt_Drx)
+#define MCAN_INTERRUPT_MASK_ELO MCAN_INTERRUPT_MASK(Mcan_Interrupt_Elo)
+#define MCAN_INTERRUPT_MASK_EP MCAN_INTERRUPT_MASK(Mcan_Interrupt_Ep)
+#define MCAN_INTERRUPT_MASK_EW MCAN_INTERRUPT_MASK(Mcan_Interrupt_Ew)
+#define MCAN_INTERRUPT_MASK_BO MCAN_INTERRUPT_MASK(Mcan_Interrupt_Bo)
+#define MCAN_INTERRUPT_MASK_WDI MCAN_INTERRUPT_MASK(Mcan_Interrupt_Wdi)
+#define MCAN_INTERRUPT_MASK_PEA MCAN_INTERRUPT_MASK(Mcan_Interrupt_Pea)
+#define MCAN_INTERRUPT_MASK_PED MCAN_INTERRUPT_MASK(Mcan_Interrupt_Ped)
+#define MCAN_INTERRUPT_MASK_ARA MCAN_INTERRUPT_MASK(Mcan_Interrupt_Ara)
+
+/// \brief Rx FIFO 0 interrupts.
+#define MCAN_INTERRUPT_MASK_RX_FIFO0                                           \
+	(MCAN_INTERRUPT_MASK_RF0N                                              \
+			| MCAN_INTERRUPT_MASK_RF0W                             \
+			| MCAN_INTERRUPT_MASK_RF0F                             \
+			| MCAN_INTERRUPT_MASK_RF0L)
+/// \brief Rx FIFO 1 interrupts.
+#define MCAN_INTERRUPT_MASK_RX_FIFO1                                           \
+	(MCAN_INTERRUPT_MASK_RF1N                                              \
+			| MCAN_INTERRUPT_MASK_RF1W                             \
+			| MCAN_INTERRUPT_MASK_RF1F                             \
+			| MCAN_INTERRUPT_MASK_RF1L)
+/// \brief Transmission completion interrupts.
+#define MCAN_INTERRUPT_MASK_TX_COMPLETE                                        \
+	(MCAN_INTERRUPT_MASK_TC                                                \
+			| MCAN_INTERRUPT_MASK_TCF                              \
+			| MCAN_INTERRUPT_MASK_TFE)
+/// \brief Tx Event FIFO interrupts.
+#define MCAN_INTERRUPT_MASK_TX_EVENT                                           \
+	(MCAN_INTERRUPT_MASK_TEFN                                              \
+			| MCAN_INTERRUPT_MASK_TEFW                             \
+			| MCAN_INTERRUPT_MASK_TEFF                             \
+			| MCAN_INTERRUPT_MASK_TEFL)
+/// \brief Error interrupts.
+#define MCAN_INTERRUPT_MASK_ERROR                                              \
+	(MCAN_INTERRUPT_MASK_MRAF                                              \
+			| MCAN_INTERRUPT_MASK_TOO                              \
+			| MCAN_INTERRUPT_MASK_ELO                              \
+			| MCAN_INTERRUPT_MASK_EP                               \
+			| MCAN_INTERRUPT_MASK_EW                               \
+			| MCAN_INTERRUPT_MASK_BO                               \
+			| MCAN_INTERRUPT_MASK_WDI                              \
+			| MCAN_INTERRUPT_MASK_PEA                              \
+			| MCAN_INTERRUPT_MASK_PED                              \
+			| MCAN_INTERRUPT_MASK_ARA)
+/// \brief Remaining interrupts.
+#define MCAN_INTERRUPT_MASK_OTHER                                              \
+	(MCAN_INTERRUPT_MASK_HPM                                               \
+			| MCAN_INTERRUPT_MASK_TSW                              \
+			| MCAN_INTERRUPT_MASK_DRX)
+/// \brief All interrupts, excluding the reserved bits.
+#define MCAN_INTERRUPT_MASK_ALL                                                \
+	(MCAN_INTERRUPT_MASK_RX_FIFO0                                          \
+			| MCAN_INTERRUPT_MASK_RX_FIFO1                         \
+			| MCAN_INTERRUPT_MASK_TX_COMPLETE                      \
+			| MCAN_INTERRUPT_MASK_TX_EVENT                         \
+			| MCAN_INTERRUPT_MASK_ERROR                            \
+			| MCAN_INTERRUPT_MASK_OTHER)
+
 /// \brief Line connected to given MCAN interrupt.
 typedef enum {
 	Mcan_InterruptLine_0 = 0, ///< Interrupt Line 0.
@@ -298,6 +381,39 @@ typedef struct {
 	bool hasAraOccured; ///< Access to Reserved Address interrupt occured.
 } Mcan_InterruptStatus;
 
+/// \brief Groups of MCAN interrupts dispatched to a common handler by
+///        Mcan_handleInterrupt.
+typedef enum {
+	/// \brief Rx FIFO 0 New Message, Watermark Reached, Full and Message Lost.
+	Mcan_InterruptGroup_RxFifo0 = 0,
+	/// \brief Rx FIFO 1 New Message, Watermark Reached, Full and Message Lost.
+	Mcan_InterruptGroup_RxFifo1 = 1,
+	/// \brief Transmission Completed, Cancellation Finished and Tx FIFO Empty.
+	Mcan_InterruptGroup_TxComplete = 2,
+	/// \brief Tx Event FIFO New Entry, Watermark Reached, Full and Element Lost.
+	Mcan_InterruptGroup_TxEvent = 3,
+	/// \brief Message RAM Access Failure, Timeout, Error Logging Overflow,
+	///        Error Passive, Warning, Bus_Off, Watchdog, Protocol Errors and
+	///        Access to Reserved Address.
+	Mcan_InterruptGroup_Error = 4,
+	/// \brief High Priority Message, Timestamp Wraparound and Message stored
+	///        to Dedicated Rx Buffer.
+	Mcan_InterruptGroup_Other = 5,
+	Mcan_InterruptGroup_Count = 6, ///< Number of interrupt groups.
+} Mcan_InterruptGroup;
+
+/// \brief A function serving as a callback called upon an MCAN interrupt.
+/// \param [in] flags Raw interrupt flags (IR register bits) of the handled
+///        interrupt group.
+/// \param [in] arg Argument registered together with the callback.
+typedef void (*McanInterruptCallback)(uint32_t flags, void *arg);
+
+/// \brief A descriptor of an MCAN interrupt group handler.
+typedef struct {
+	McanInterruptCallback callback; ///< Callback function.
+	void *arg; ///< Argument to the callback function.
+} Mcan_InterruptHandler;
+
 /// \brief Mcan configuration structure.
 typedef struct {
 	/// \brief Base address of the message ram; only the upper 16 bits are
@@ -394,6 +510,14 @@ typedef struct {
 	bool isInterruptEnabled; ///< Enable interrupt after transmission complete.
 } Mcan_TxElement;
 
+/// \brief Mcan Tx element with a pre-encoded header, used to send frames with
+///        the same identifier, flags and data size repeatedly.
+typedef struct {
+	uint32_t header[2]; ///< Encoded T0 and T1 words of the Tx element.
+	uint8_t dataSize; ///< Number of data bytes.
+	bool isInterruptEnabled; ///< Enable interrupt after transmission complete.
+} Mcan_TxTemplate;
+
 /// \brief Mcan Tx element for Tx Event FIFO.
 typedef struct {
 	Mcan_ElementEsi esiFlag; ///< CAN FD ESI flag value.
@@ -431,6 +555,30 @@ typedef struct {
 	uint8_t *data; ///< Data pointer.
 } Mcan_RxElement;
 
+/// \brief A function serving as a callback called for each Dedicated Rx
+///        Buffer holding new data.
+/// \param [in] index Rx Buffer index.
+/// \param [in] element Received element; its data is valid only during the
+///        call.
+/// \param [in] arg Argument registered together with the callback.
+typedef void (*McanRxBufferCallback)(
+		uint8_t index, const Mcan_RxElement *element, void *arg);
+
+/// \brief A descriptor of a Dedicated Rx Buffer new data handler.
+typedef struct {
+	McanRxBufferCallback callback; ///< Callback function.
+	void *arg; ///< Argument to the callback function.
+} Mcan_RxBufferHandler;
+
+/// \brief A view of an Rx element stored in the message RAM. The element is
+///        decoded lazily by the Mcan_rxView* accessors and stays valid until
+///        released with Mcan_rxFifoRelease.
+typedef struct {
+	const uint32_t *address; ///< Address of the element within message RAM.
+	Mcan_RxFifoId fifoId; ///< Id of the Rx FIFO containing the element.
+	uint8_t index; ///< Index of the element within the Rx FIFO.
+} Mcan_RxElementView;
+
 /// \brief The type of Rx filter.
 typedef enum {
 	Mcan_RxFilterType_Range = 0, ///< Range filter; id1 <= id <= id2.
@@ -487,6 +635,17 @@ typedef struct {
 	uint8_t rxStdFilterSize; ///< Size (number of 32-bit words) of the Standard Id filter.
 	uint32_t *rxExtFilterAddress; ///< Address (32-bit) of the Extended Id filter within message RAM.
 	uint8_t rxExtFilterSize; ///< Size (number of 32-bit words) of the Extended Id filter.
+	/// \brief Enabled interrupts routed to each of the interrupt lines.
+	uint32_t lineInterruptMasks[2];
+	/// \brief Shadow copy of the Tx Buffer Transmission Interrupt Enable
+	///        register, updated atomically by all Tx functions.
+	uint32_t txInterruptEnables;
+	/// \brief Tx Buffers reserved by Mcan_txSubmit calls in progress.
+	uint32_t txReservedBuffers;
+	/// \brief Handlers of the interrupt groups, called by Mcan_handleInterrupt.
+	Mcan_InterruptHandler interruptHandlers[Mcan_InterruptGroup_Count];
+	/// \brief Handler of Dedicated Rx Buffers with new data.
+	Mcan_RxBufferHandler rxBufferHandler;
 } Mcan;
 
 /// \brief Initializes a device descriptor for Mcan.
@@ -529,6 +688,118 @@ bool Mcan_txBufferAdd(Mcan *const mcan, const Mcan_TxElement element,
 bool Mcan_txQueuePush(Mcan *const mcan, const Mcan_TxElement element,
 		uint8_t *const index, int *const errCode);
 
+/// \brief Adds up to count elements to the Tx Queue and requests their
+///        transmission with a single write of the add request register (two,
+///        if the elements wrap around the end of the Tx FIFO). The Tx FIFO
+///        status is read once and elements are written into consecutive free
+///        buffers, preserving their order in the Tx FIFO.
+/// \param [in] mcan Mcan device descriptor.
+/// \param [in] elements Array of Tx elements to send.
+/// \param [in] count Number of elements in the array.
+/// \param [out] pushedCount Number of elements added to the Tx Queue.
+/// \param [out] errCode An error code generated during the operation.
+/// \retval true At least one element was added, or count is zero.
+/// \retval false Adding elements failed.
+bool Mcan_txQueuePushBatch(Mcan *const mcan,
+		const Mcan_TxElement *const elements, const uint32_t count,
+		uint32_t *const pushedCount, int *const errCode);
+
+/// \brief Encodes the header of a Tx element into a Tx template. The data
+///        pointer of the element is not used.
+/// \param [in] element Tx element.
+/// \param [out] tmpl Tx template.
+void Mcan_txTemplatePrepare(
+		const Mcan_TxElement *const element, Mcan_TxTemplate *const tmpl);
+
+/// \brief Changes the message marker of a Tx template.
+/// \param [in,out] tmpl Tx template.
+/// \param [in] marker Message marker to be placed in the Tx Event FIFO.
+static inline void
+Mcan_txTemplateSetMarker(Mcan_TxTemplate *const tmpl, const uint8_t marker)
+{
+	tmpl->header[MCAN_TXELEMENT_MM_WORD] =
+			(tmpl->header[MCAN_TXELEMENT_MM_WORD]
+					& ~MCAN_TXELEMENT_MM_MASK)
+			| (((uint32_t)marker << MCAN_TXELEMENT_MM_OFFSET)
+					& MCAN_TXELEMENT_MM_MASK);
+}
+
+/// \brief Adds a frame described by a Tx template to the Tx Buffer and
+///        initializes its transmission.
+/// \param [in] mcan Mcan device descriptor.
+/// \param [in] tmpl Tx template.
+/// \param [in] data Frame data, of the size given in the template.
+/// \param [in] index Tx Buffer index.
+/// \param [out] errCode An error code generated during the operation.
+/// \retval true Adding element was successful.
+/// \retval false Adding element failed.
+bool Mcan_txBufferAddTemplate(Mcan *const mcan,
+		const Mcan_TxTemplate *const tmpl, const uint8_t *const data,
+		const uint8_t index, int *const errCode);
+
+/// \brief Adds a frame described by a Tx template to the Tx Queue and
+///        initializes its transmission.
+/// \param [in] mcan Mcan device descriptor.
+/// \param [in] tmpl Tx template.
+/// \param [in] data Frame data, of the size given in the template.
+/// \param [out] index Memory buffer index at which the element was added.
+/// \param [out] errCode An error code generated during the operation.
+/// \retval true Adding element was successful.
+/// \retval false Adding element failed.
+bool Mcan_txQueuePushTemplate(Mcan *const mcan,
+		const Mcan_TxTemplate *const tmpl, const uint8_t *const data,
+		uint8_t *const index, int *const errCode);
+
+/// \brief Adds up to count frames described by Tx templates to the Tx Queue,
+///        in the same way as Mcan_txQueuePushBatch.
+/// \param [in] mcan Mcan device descriptor.
+/// \param [in] templates Array of Tx templates.
+/// \param [in] data Array of pointers to the frame data, of the sizes given
+///        in the corresponding templates.
+/// \param [in] count Number of frames.
+/// \param [out] pushedCount Number of frames added to the Tx Queue.
+/// \param [out] errCode An error code generated during the operation.
+/// \retval true At least one frame was added, or count is zero.
+/// \retval false Adding frames failed.
+bool Mcan_txQueuePushTemplateBatch(Mcan *const mcan,
+		const Mcan_TxTemplate *const templates,
+		const uint8_t *const *const data, const uint32_t count,
+		uint32_t *const pushedCount, int *const errCode);
+
+/// \brief Sends a frame using a free buffer from the mask. Safe to call
+///        concurrently from several interrupt priorities and thread context,
+///        without masking interrupts: buffers are reserved atomically and the
+///        transmission interrupt enables are updated through a shadow copy.
+///        Each context may use a disjoint mask, avoiding contention, or
+///        contexts may share buffers. The mask may contain dedicated Tx
+///        Buffers, and Tx Queue buffers if the queue is in ID mode; the
+///        buffers shall not be used by the other Tx functions.
+/// \param [in] mcan Mcan device descriptor.
+/// \param [in] element Tx element to send.
+/// \param [in] bufferMask Mask of the buffers usable by the caller.
+/// \param [out] index Memory buffer index at which the element was added.
+/// \param [out] errCode An error code generated during the operation.
+/// \retval true Adding element was successful.
+/// \retval false Adding element failed, all buffers from the mask are busy.
+bool Mcan_txSubmit(Mcan *const mcan, const Mcan_TxElement *const element,
+		const uint32_t bufferMask, uint8_t *const index,
+		int *const errCode);
+
+/// \brief Sends a frame described by a Tx template in the same way as
+///        Mcan_txSubmit.
+/// \param [in] mcan Mcan device descriptor.
+/// \param [in] tmpl Tx template.
+/// \param [in] data Frame data, of the size given in the template.
+/// \param [in] bufferMask Mask of the buffers usable by the caller.
+/// \param [out] index Memory buffer index at which the element was added.
+/// \param [out] errCode An error code generated during the operation.
+/// \retval true Adding element was successful.
+/// \retval false Adding element failed, all buffers from the mask are busy.
+bool Mcan_txSubmitTemplate(Mcan *const mcan,
+		const Mcan_TxTemplate *const tmpl, const uint8_t *const data,
+		const uint32_t bufferMask, uint8_t *const index,
+		int *const errCode);
+
 /// \brief Checks whether the specified Tx Buffer or Queue element was sent.
 /// \param [in] mcan Mcan device descriptor.
 /// \param [in] index Queried element index.
@@ -546,6 +817,19 @@ bool Mcan_txBufferIsTransmissionFinished(
 bool Mcan_txEventFifoPull(Mcan *const mcan, Mcan_TxEventElement *const element,
 		int *const errCode);
 
+/// \brief Pulls up to maxCount elements from the Tx Event FIFO, reading its
+///        status once and acknowledging all pulled elements with a single write.
+/// \param [in] mcan Mcan device descriptor.
+/// \param [out] elements Array of Tx Event elements.
+/// \param [in] maxCount Number of elements in the array.
+/// \param [out] pulledCount Number of pulled elements.
+/// \param [out] errCode An error code generated during the operation.
+/// \retval true At least one element was pulled.
+/// \retval false Pulling elements failed.
+bool Mcan_txEventFifoPullBatch(Mcan *const mcan,
+		Mcan_TxEventElement *const elements, const uint32_t maxCount,
+		uint32_t *const pulledCount, int *const errCode);
+
 /// \brief Receives element from the Rx Buffer.
 /// \param [in] mcan Mcan device descriptor.
 /// \param [in] index Index of the Rx element to obtain.
@@ -553,6 +837,25 @@ bool Mcan_txEventFifoPull(Mcan *const mcan, Mcan_TxEventElement *const element,
 void Mcan_rxBufferGet(Mcan *const mcan, const uint8_t index,
 		Mcan_RxElement *const element);
 
+/// \brief Registers the handler called by Mcan_rxBufferScan. When registered,
+///        Mcan_handleInterrupt scans the Rx Buffers upon the Message stored
+///        to Dedicated Rx Buffer interrupt (Mcan_Interrupt_Drx), before
+///        calling the interrupt group handlers. Passing a NULL callback
+///        unregisters the handler.
+/// \param [in] mcan Mcan device descriptor.
+/// \param [in] handler Rx Buffer handler.
+void Mcan_setRxBufferHandler(
+		Mcan *const mcan, const Mcan_RxBufferHandler handler);
+
+/// \brief Receives elements from the Dedicated Rx Buffers with new data. The
+///        New Data registers are read once, only the flagged buffers are
+///        decoded and passed to the registered handler, in the order of
+///        indexes, and their flags are cleared with a single write of each
+///        New Data register.
+/// \param [in] mcan Mcan device descriptor.
+/// \returns Number of received elements.
+uint32_t Mcan_rxBufferScan(Mcan *const mcan);
+
 /// \brief Pulls element the Rx Fifo.
 /// \param [in] mcan Mcan device descriptor.
 /// \param [in] id The id of the Rx Fifo.
@@ -563,6 +866,116 @@ void Mcan_rxBufferGet(Mcan *const mcan, const uint8_t index,
 bool Mcan_rxFifoPull(Mcan *const mcan, const Mcan_RxFifoId id,
 		Mcan_RxElement *const element, int *const errCode);
 
+/// \brief Pulls up to maxCount elements from the Rx Fifo. The Fifo status is
+///        read once and only the last pulled element is acknowledged, which
+///        releases all of the pulled elements at once.
+/// \param [in] mcan Mcan device descriptor.
+/// \param [in] id The id of the Rx Fifo.
+/// \param [out] elements Array of Rx elements; the data pointer of each
+///        element shall point to a buffer large enough for the Rx element data.
+/// \param [in] maxCount Number of elements in the array.
+/// \param [out] pulledCount Number of pulled elements.
+/// \param [out] errCode An error code generated during the operation.
+/// \retval true At least one element was pulled.
+/// \retval false Pulling elements failed.
+bool Mcan_rxFifoPullBatch(Mcan *const mcan, const Mcan_RxFifoId id,
+		Mcan_RxElement *const elements, const uint32_t maxCount,
+		uint32_t *const pulledCount, int *const errCode);
+
+/// \brief Obtains a view of the oldest element of the Rx Fifo, without
+///        decoding or copying it. The element is not removed from the Fifo
+///        until released with Mcan_rxFifoRelease.
+/// \param [in] mcan Mcan device descriptor.
+/// \param [in] id The id of the Rx Fifo.
+/// \param [out] view Rx element view.
+/// \param [out] errCode An error code generated during the operation.
+/// \retval true Obtaining the element view was successful.
+/// \retval false Obtaining the element view failed.
+bool Mcan_rxFifoPeek(const Mcan *const mcan, const Mcan_RxFifoId id,
+		Mcan_RxElementView *const view, int *const errCode);
+
+/// \brief Obtains views of up to maxCount oldest elements of the Rx Fifo,
+///        reading the Fifo status once. Releasing the view of the last element
+///        removes all of them from the Fifo.
+/// \param [in] mcan Mcan device descriptor.
+/// \param [in] id The id of the Rx Fifo.
+/// \param [out] views Array of Rx element views, from the oldest element.
+/// \param [in] maxCount Number of views in the array.
+/// \param [out] peekedCount Number of obtained views.
+/// \param [out] errCode An error code generated during the operation.
+/// \retval true At least one element view was obtained.
+/// \retval false Obtaining the element views failed.
+bool Mcan_rxFifoPeekBatch(const Mcan *const mcan, const Mcan_RxFifoId id,
+		Mcan_RxElementView *const views, const uint32_t maxCount,
+		uint32_t *const peekedCount, int *const errCode);
+
+/// \brief Acknowledges the element viewed with Mcan_rxFifoPeek, removing it
+///        (and all older elements) from the Rx Fifo.
+/// \param [in] mcan Mcan device descriptor.
+/// \param [in] view Rx element view.
+void Mcan_rxFifoRelease(Mcan *const mcan, const Mcan_RxElementView *const view);
+
+/// \brief Returns the type of identifier of the viewed Rx element.
+/// \param [in] view Rx element view.
+/// \returns Identifier type.
+static inline Mcan_IdType
+Mcan_rxViewGetIdType(const Mcan_RxElementView *const view)
+{
+	return (Mcan_IdType)((view->address[MCAN_RXELEMENT_XTD_WORD]
+					     & MCAN_RXELEMENT_XTD_MASK)
+			>> MCAN_RXELEMENT_XTD_OFFSET);
+}
+
+/// \brief Returns the identifier of the viewed Rx element.
+/// \param [in] view Rx element view.
+/// \returns Standard or extended identifier, depending on the identifier type.
+static inline uint32_t
+Mcan_rxViewGetId(const Mcan_RxElementView *const view)
+{
+	const uint32_t word = view->address[MCAN_RXELEMENT_XTD_WORD];
+	if ((word & MCAN_RXELEMENT_XTD_MASK) == 0u)
+		return (word & MCAN_RXELEMENT_STDID_MASK)
+				>> MCAN_RXELEMENT_STDID_OFFSET;
+	return (word & MCAN_RXELEMENT_EXTID_MASK) >> MCAN_RXELEMENT_EXTID_OFFSET;
+}
+
+/// \brief Returns the index of the filter which accepted the viewed Rx element.
+/// \param [in] view Rx element view.
+/// \returns Filter index.
+static inline uint8_t
+Mcan_rxViewGetFilterIndex(const Mcan_RxElementView *const view)
+{
+	return (uint8_t)((view->address[MCAN_RXELEMENT_FIDX_WORD]
+					 & MCAN_RXELEMENT_FIDX_MASK)
+			>> MCAN_RXELEMENT_FIDX_OFFSET);
+}
+
+/// \brief Returns the reception timestamp of the viewed Rx element.
+/// \param [in] view Rx element view.
+/// \returns Timestamp.
+static inline uint16_t
+Mcan_rxViewGetTimestamp(const Mcan_RxElementView *const view)
+{
+	return (uint16_t)((view->address[MCAN_RXELEMENT_RXTS_WORD]
+					  & MCAN_RXELEMENT_RXTS_MASK)
+			>> MCAN_RXELEMENT_RXTS_OFFSET);
+}
+
+/// \brief Returns the number of data bytes of the viewed Rx element.
+/// \param [in] view Rx element view.
+/// \returns Data size in bytes.
+uint8_t Mcan_rxViewGetDataSize(const Mcan_RxElementView *const view);
+
+/// \brief Returns a pointer to the data of the viewed Rx element, located in
+///        the message RAM.
+/// \param [in] view Rx element view.
+/// \returns Pointer to the element data.
+static inline const uint8_t *
+Mcan_rxViewGetData(const Mcan_RxElementView *const view)
+{
+	return (const uint8_t *)&view->address[MCAN_RXELEMENT_DATA_WORD];
+}
+
 /// \brief Reads the status of the Rx Fifo.
 /// \param [in] mcan Mcan device descriptor.
 /// \param [in] id The id of the Rx Fifo.
@@ -613,6 +1026,68 @@ bool Mcan_setExtendedIdFilter(Mcan *const mcan,
 void Mcan_getInterruptStatus(
 		const Mcan *const mcan, Mcan_InterruptStatus *const status);
 
+/// \brief Sets the enabled interrupts and their lines with a single write of
+///        the interrupt enable and line select registers.
+/// \param [in] mcan Mcan device descriptor.
+/// \param [in] enableMask Mask of the enabled interrupts.
+/// \param [in] line1Mask Mask of the interrupts routed to line 1; the
+///        remaining ones are routed to line 0.
+void Mcan_setInterruptMasks(Mcan *const mcan, const uint32_t enableMask,
+		const uint32_t line1Mask);
+
+/// \brief Enables the given interrupts, leaving the others unchanged.
+/// \param [in] mcan Mcan device descriptor.
+/// \param [in] mask Mask of the interrupts to enable.
+void Mcan_enableInterrupts(Mcan *const mcan, const uint32_t mask);
+
+/// \brief Disables the given interrupts, leaving the others unchanged.
+/// \param [in] mcan Mcan device descriptor.
+/// \param [in] mask Mask of the interrupts to disable.
+void Mcan_disableInterrupts(Mcan *const mcan, const uint32_t mask);
+
+/// \brief Returns the raw interrupt flags without clearing them.
+/// \param [in] mcan Mcan device descriptor.
+/// \returns Mask of the pending interrupts.
+static inline uint32_t
+Mcan_getInterruptFlags(const Mcan *const mcan)
+{
+	return mcan->reg->ir;
+}
+
+/// \brief Reads and clears the pending interrupts selected by the mask, with
+///        a single read and write of the interrupt register. Several
+///        conditions can then be tested at once, e.g.
+///        (flags & (MCAN_INTERRUPT_MASK_RF0N | MCAN_INTERRUPT_MASK_TC)).
+/// \param [in] mcan Mcan device descriptor.
+/// \param [in] mask Mask of the interrupts to read and clear.
+/// \returns Mask of the pending interrupts which were cleared.
+static inline uint32_t
+Mcan_clearInterruptFlags(Mcan *const mcan, const uint32_t mask)
+{
+	const uint32_t flags = mcan->reg->ir & mask;
+	mcan->reg->ir = flags;
+	return flags;
+}
+
+/// \brief Registers a handler of an interrupt group, called by
+///        Mcan_handleInterrupt. Passing a NULL callback unregisters the handler.
+/// \param [in] mcan Mcan device descriptor.
+/// \param [in] group Interrupt group.
+/// \param [in] handler Interrupt group handler.
+void Mcan_setInterruptHandler(Mcan *const mcan,
+		const Mcan_InterruptGroup group, const Mcan_InterruptHandler handler);
+
+/// \brief Handles an interrupt of the Mcan device on the given line. Reads and
+///        clears the pending interrupts routed to the line once, then calls the
+///        registered handler of each interrupt group with pending interrupts.
+///        Shall be called from the interrupt handler of the line, e.g. installed
+///        in the vector table using Nvic_setInterruptHandlerAddress with
+///        Nvic_Irq_Mcan0_Irq0, Nvic_Irq_Mcan0_Irq1, Nvic_Irq_Mcan1_Irq0 or
+///        Nvic_Irq_Mcan1_Irq1.
+/// \param [in] mcan Mcan device descriptor.
+/// \param [in] line Interrupt line.
+void Mcan_handleInterrupt(Mcan *const mcan, const Mcan_InterruptLine line);
+
 /// \brief Resets the timeout counter value when in Continuous mode.
 /// \param [in] mcan Mcan device descriptor.
 static inline void
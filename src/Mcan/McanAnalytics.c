@@ -0,0 +1,238 @@
+/**@file
+ * This file is part of the ARM BSP for the Test Environment.
+ *
+ * @copyright 2020-2021 N7 Space Sp. z o.o.
+ *
+ * Test Environment was developed under a programme of,
+ * and funded by, the European Space Agency (the "ESA").
+ *
+ *
+ * Licensed under the ESA Public License (ESA-PL) Permissive,
+ * Version 2.3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://essr.esa.int/license/list
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "McanAnalytics.h"
+
+#include <assert.h>
+#include <stddef.h>
+#include <string.h>
+
+#define PICOSECONDS_PER_SECOND 1000000000000ull
+#define PICOSECONDS_PER_MICROSECOND 1000000u
+#define MICROSECONDS_PER_SECOND 1000000u
+#define BUS_LOAD_SCALE 10000u
+
+// Frame lengths in bits, excluding stuff bits and data bytes; they include
+// the 3-bit interframe space.
+#define CLASSIC_STANDARD_FRAME_BITS 47u
+#define CLASSIC_EXTENDED_FRAME_BITS 67u
+// CAN FD frames: arbitration phase from SOF to BRS, data phase from ESI to
+// CRC delimiter and the nominal rate tail from ACK to interframe space.
+#define FD_STANDARD_ARBITRATION_BITS 17u
+#define FD_EXTENDED_ARBITRATION_BITS 36u
+#define FD_SHORT_DATA_PHASE_BITS 27u
+#define FD_LONG_DATA_PHASE_BITS 31u
+#define FD_LONG_CRC_DATA_SIZE 16u
+#define FD_TAIL_BITS 12u
+
+#define JITTER_SCALE_BITS 4u
+
+static uint32_t
+getBitTimePs(const uint32_t bitRate)
+{
+	if (bitRate == 0u)
+		return 0u;
+	return (uint32_t)(PICOSECONDS_PER_SECOND / bitRate);
+}
+
+void
+McanAnalytics_init(McanAnalytics *const analytics,
+		const McanAnalytics_Config *const config, const uint64_t now)
+{
+	assert(analytics != NULL);
+	assert(config != NULL);
+
+	memset(analytics, 0, sizeof(McanAnalytics));
+	analytics->config = *config;
+	analytics->nominalBitTimePs = getBitTimePs(config->nominalBitRate);
+	analytics->dataBitTimePs = getBitTimePs(config->dataBitRate);
+	analytics->windowStart = now;
+
+	if (config->latencies != NULL)
+		memset(config->latencies, 0,
+				config->latencyCount
+						* sizeof(McanAnalytics_Latency));
+	if (config->streams != NULL)
+		memset(config->streams, 0,
+				config->streamCount
+						* sizeof(McanAnalytics_Stream));
+}
+
+uint64_t
+McanAnalytics_getFrameTime(const McanAnalytics *const analytics,
+		const Mcan_IdType idType, const bool isCanFd,
+		const bool isBitRateSwitched, const uint8_t dataSize)
+{
+	const uint32_t dataBits = 8u * dataSize;
+	const uint64_t nominalBitTime = analytics->nominalBitTimePs;
+
+	if (!isCanFd) {
+		const uint32_t frameBits = (idType == Mcan_IdType_Standard)
+				? CLASSIC_STANDARD_FRAME_BITS
+				: CLASSIC_EXTENDED_FRAME_BITS;
+		return (frameBits + dataBits) * nominalBitTime;
+	}
+
+	const uint32_t arbitrationBits = (idType == Mcan_IdType_Standard)
+			? FD_STANDARD_ARBITRATION_BITS
+			: FD_EXTENDED_ARBITRATION_BITS;
+	const uint32_t dataPhaseBits = dataBits
+			+ ((dataSize > FD_LONG_CRC_DATA_SIZE)
+							? FD_LONG_DATA_PHASE_BITS
+							: FD_SHORT_DATA_PHASE_BITS);
+	const uint64_t dataBitTime = isBitRateSwitched
+			? analytics->dataBitTimePs
+			: nominalBitTime;
+	return ((arbitrationBits + FD_TAIL_BITS) * nominalBitTime)
+			+ (dataPhaseBits * dataBitTime);
+}
+
+static uint32_t
+getLatencyBin(const uint32_t latency)
+{
+	if (latency == 0u)
+		return 0u;
+	const uint32_t bin = 32u - (uint32_t)__builtin_clz(latency);
+	return (bin < MCAN_ANALYTICS_LATENCY_BINS)
+			? bin
+			: (MCAN_ANALYTICS_LATENCY_BINS - 1u);
+}
+
+static uint32_t
+saturate(const uint64_t value)
+{
+	return (value > UINT32_MAX) ? UINT32_MAX : (uint32_t)value;
+}
+
+void
+McanAnalytics_recordQueued(McanAnalytics *const analytics,
+		const uint8_t marker, const uint64_t timestamp)
+{
+	if (marker >= analytics->config.latencyCount)
+		return;
+
+	McanAnalytics_Latency *const latency =
+			&analytics->config.latencies[marker];
+	latency->queuedTimestamp = timestamp;
+	latency->isQueued = true;
+}
+
+void
+McanAnalytics_recordTxEvent(McanAnalytics *const analytics,
+		const Mcan_TxEventElement *const event, const uint64_t timestamp)
+{
+	analytics->busyTimePs += McanAnalytics_getFrameTime(analytics,
+			event->idType, event->isCanFdFormatEnabled,
+			event->isBitRateSwitchingEnabled, event->dataSize);
+	analytics->txFrameCount++;
+
+	if (event->marker >= analytics->config.latencyCount)
+		return;
+	McanAnalytics_Latency *const latency =
+			&analytics->config.latencies[event->marker];
+	if (!latency->isQueued || (timestamp < latency->queuedTimestamp))
+		return;
+
+	const uint32_t value = saturate(timestamp - latency->queuedTimestamp);
+	latency->isQueued = false;
+	if ((latency->count == 0u) || (value < latency->min))
+		latency->min = value;
+	if (value > latency->max)
+		latency->max = value;
+	latency->sum += value;
+	latency->count++;
+	latency->bins[getLatencyBin(value)]++;
+}
+
+static void
+updateStream(McanAnalytics_Stream *const stream, const uint64_t timestamp)
+{
+	if ((stream->count == 0u) || (timestamp < stream->lastTimestamp)) {
+		stream->lastTimestamp = timestamp;
+		stream->count = 1u;
+		return;
+	}
+
+	const uint32_t interval = saturate(timestamp - stream->lastTimestamp);
+	if ((stream->count == 1u) || (interval < stream->minInterval))
+		stream->minInterval = interval;
+	if (interval > stream->maxInterval)
+		stream->maxInterval = interval;
+	stream->intervalSum += interval;
+
+	if (stream->count > 1u) {
+		const uint32_t difference = (interval > stream->lastInterval)
+				? (interval - stream->lastInterval)
+				: (stream->lastInterval - interval);
+		// J += (D - J) / 16, with J kept multiplied by 16.
+		stream->scaledJitter = stream->scaledJitter + difference
+				- (stream->scaledJitter >> JITTER_SCALE_BITS);
+	}
+
+	stream->lastInterval = interval;
+	stream->lastTimestamp = timestamp;
+	stream->count++;
+}
+
+void
+McanAnalytics_recordRx(McanAnalytics *const analytics,
+		const Mcan_RxElement *const element, const uint64_t timestamp,
+		const uint32_t streamIndex)
+{
+	analytics->busyTimePs += McanAnalytics_getFrameTime(analytics,
+			element->idType, element->isCanFdFormatEnabled,
+			element->isBitRateSwitchingEnabled, element->dataSize);
+	analytics->rxFrameCount++;
+
+	if (streamIndex < analytics->config.streamCount)
+		updateStream(&analytics->config.streams[streamIndex],
+				timestamp);
+}
+
+uint32_t
+McanAnalytics_getBusLoad(
+		const McanAnalytics *const analytics, const uint64_t now)
+{
+	if ((now <= analytics->windowStart)
+			|| (analytics->config.timestampFrequency == 0u))
+		return 0u;
+
+	const uint64_t elapsedUs = ((now - analytics->windowStart)
+						   * MICROSECONDS_PER_SECOND)
+			/ analytics->config.timestampFrequency;
+	if (elapsedUs == 0u)
+		return 0u;
+	const uint64_t busyUs =
+			analytics->busyTimePs / PICOSECONDS_PER_MICROSECOND;
+	const uint64_t load = (busyUs * BUS_LOAD_SCALE) / elapsedUs;
+	return (load > BUS_LOAD_SCALE) ? BUS_LOAD_SCALE : (uint32_t)load;
+}
+
+void
+McanAnalytics_restartWindow(McanAnalytics *const analytics, const uint64_t now)
+{
+	analytics->windowStart = now;
+	analytics->busyTimePs = 0;
+	analytics->rxFrameCount = 0;
+	analytics->txFrameCount = 0;
+}
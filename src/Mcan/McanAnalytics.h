@@ -0,0 +1,159 @@
+/**@file
+ * This file is part of the ARM BSP for the Test Environment.
+ *
+ * @copyright 2020-2021 N7 Space Sp. z o.o.
+ *
+ * Test Environment was developed under a programme of,
+ * and funded by, the European Space Agency (the "ESA").
+ *
+ *
+ * Licensed under the ESA Public License (ESA-PL) Permissive,
+ * Version 2.3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://essr.esa.int/license/list
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @defgroup McanAnalytics McanAnalytics
+ * @ingroup Mcan
+ * @{
+ */
+
+#ifndef BSP_MCAN_ANALYTICS_H
+#define BSP_MCAN_ANALYTICS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "Mcan.h"
+
+/// \brief Number of latency histogram bins. Bin 0 counts zero latencies, bin
+///        i counts latencies in [2^(i-1), 2^i) timestamp ticks and the last
+///        bin counts all longer latencies.
+#define MCAN_ANALYTICS_LATENCY_BINS 16u
+
+/// \brief Stream index of Rx frames excluded from the inter-arrival
+///        statistics.
+#define MCAN_ANALYTICS_NO_STREAM UINT32_MAX
+
+/// \brief Queue-to-wire latency statistics of frames sent with a marker, in
+///        timestamp ticks.
+typedef struct {
+	uint64_t queuedTimestamp; ///< Timestamp of the last queued frame.
+	bool isQueued; ///< Flag indicating whether a frame is awaiting its event.
+	uint32_t count; ///< Number of measured frames.
+	uint32_t min; ///< Shortest latency.
+	uint32_t max; ///< Longest latency.
+	uint64_t sum; ///< Sum of latencies.
+	uint32_t bins[MCAN_ANALYTICS_LATENCY_BINS]; ///< Latency histogram.
+} McanAnalytics_Latency;
+
+/// \brief Inter-arrival statistics of an Rx frame stream, in timestamp ticks.
+typedef struct {
+	uint64_t lastTimestamp; ///< Timestamp of the last frame.
+	uint32_t lastInterval; ///< Last inter-arrival interval.
+	uint32_t count; ///< Number of received frames.
+	uint32_t minInterval; ///< Shortest inter-arrival interval.
+	uint32_t maxInterval; ///< Longest inter-arrival interval.
+	uint64_t intervalSum; ///< Sum of inter-arrival intervals.
+	/// \brief Interval jitter estimate multiplied by 16, smoothed as in
+	///        RFC 3550: J += (|I(n) - I(n-1)| - J) / 16.
+	uint32_t scaledJitter;
+} McanAnalytics_Stream;
+
+/// \brief Analytics configuration and storage, provided by the user.
+typedef struct {
+	uint32_t nominalBitRate; ///< Nominal (arbitration) bit rate in [bit/s].
+	uint32_t dataBitRate; ///< CAN FD data phase bit rate in [bit/s].
+	uint32_t timestampFrequency; ///< Timestamp counter frequency in [Hz].
+	/// \brief Latency statistics indexed by the Tx element marker; can be NULL.
+	McanAnalytics_Latency *latencies;
+	uint32_t latencyCount; ///< Number of latency statistics.
+	/// \brief Inter-arrival statistics indexed by stream; can be NULL.
+	McanAnalytics_Stream *streams;
+	uint32_t streamCount; ///< Number of inter-arrival statistics.
+} McanAnalytics_Config;
+
+/// \brief Analytics descriptor.
+typedef struct {
+	McanAnalytics_Config config; ///< Configuration and storage.
+	uint32_t nominalBitTimePs; ///< Nominal bit time in [ps].
+	uint32_t dataBitTimePs; ///< Data phase bit time in [ps].
+	uint64_t windowStart; ///< Timestamp of the bus load window start.
+	uint64_t busyTimePs; ///< Bus time taken by frames in the window in [ps].
+	uint32_t rxFrameCount; ///< Number of received frames in the window.
+	uint32_t txFrameCount; ///< Number of sent frames in the window.
+} McanAnalytics;
+
+/// \brief Initializes the analytics, clearing the provided storage.
+/// \param [out] analytics Analytics descriptor.
+/// \param [in] config Configuration and storage.
+/// \param [in] now Current extended timestamp, starting the bus load window.
+void McanAnalytics_init(McanAnalytics *const analytics,
+		const McanAnalytics_Config *const config, const uint64_t now);
+
+/// \brief Records the time at which a frame with the given marker was queued
+///        for transmission. The marker shall be unique among the frames
+///        awaiting their Tx events.
+/// \param [in] analytics Analytics descriptor.
+/// \param [in] marker Tx element marker.
+/// \param [in] timestamp Extended timestamp at queuing.
+void McanAnalytics_recordQueued(McanAnalytics *const analytics,
+		const uint8_t marker, const uint64_t timestamp);
+
+/// \brief Accounts for a sent frame, updating the bus load and the latency
+///        statistics of its marker.
+/// \param [in] analytics Analytics descriptor.
+/// \param [in] event Tx Event element of the frame.
+/// \param [in] timestamp Extended timestamp of the Tx event.
+void McanAnalytics_recordTxEvent(McanAnalytics *const analytics,
+		const Mcan_TxEventElement *const event, const uint64_t timestamp);
+
+/// \brief Accounts for a received frame, updating the bus load and the
+///        inter-arrival statistics of its stream.
+/// \param [in] analytics Analytics descriptor.
+/// \param [in] element Rx element of the frame.
+/// \param [in] timestamp Extended timestamp of the Rx element.
+/// \param [in] streamIndex Index of the stream, e.g. assigned per identifier,
+///        or MCAN_ANALYTICS_NO_STREAM.
+void McanAnalytics_recordRx(McanAnalytics *const analytics,
+		const Mcan_RxElement *const element, const uint64_t timestamp,
+		const uint32_t streamIndex);
+
+/// \brief Returns the bus load caused by the recorded frames since the start
+///        of the window. Frames not received due to filtering and frames of
+///        other nodes are not accounted for.
+/// \param [in] analytics Analytics descriptor.
+/// \param [in] now Current extended timestamp.
+/// \returns Bus load in units of 0.01%.
+uint32_t McanAnalytics_getBusLoad(
+		const McanAnalytics *const analytics, const uint64_t now);
+
+/// \brief Starts a new bus load window.
+/// \param [in] analytics Analytics descriptor.
+/// \param [in] now Current extended timestamp.
+void McanAnalytics_restartWindow(
+		McanAnalytics *const analytics, const uint64_t now);
+
+/// \brief Returns the duration of a frame on the bus, without stuff bits.
+/// \param [in] analytics Analytics descriptor.
+/// \param [in] idType Type of the identifier.
+/// \param [in] isCanFd CAN FD format flag.
+/// \param [in] isBitRateSwitched Bit rate switching flag.
+/// \param [in] dataSize Number of data bytes.
+/// \returns Frame duration in [ps].
+uint64_t McanAnalytics_getFrameTime(const McanAnalytics *const analytics,
+		const Mcan_IdType idType, const bool isCanFd,
+		const bool isBitRateSwitched, const uint8_t dataSize);
+
+#endif // BSP_MCAN_ANALYTICS_H
+
+/** @} */
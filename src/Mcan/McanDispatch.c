@@ -0,0 +1,193 @@
+/**@file
+ * This file is part of the ARM BSP for the Test Environment.
+ *
+ * @copyright 2020-2021 N7 Space Sp. z o.o.
+ *
+ * Test Environment was developed under a programme of,
+ * and funded by, the European Space Agency (the "ESA").
+ *
+ *
+ * Licensed under the ESA Public License (ESA-PL) Permissive,
+ * Version 2.3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://essr.esa.int/license/list
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "McanDispatch.h"
+
+#include <assert.h>
+#include <stddef.h>
+#include <string.h>
+
+#include <Utils/Utils.h>
+
+#define HASH_MULTIPLIER 0x9E3779B1u
+#define KEY_ID_TYPE_OFFSET 29u
+#define KEY_VALID_MASK 0x80000000u
+
+static inline uint32_t
+encodeKey(const Mcan_IdType idType, const uint32_t id)
+{
+	return KEY_VALID_MASK | ((uint32_t)idType << KEY_ID_TYPE_OFFSET) | id;
+}
+
+static inline uint32_t
+getHomeIndex(const McanDispatch *const dispatch, const uint32_t key)
+{
+	// Fibonacci hashing; the top bits of the product are the best mixed.
+	return (uint32_t)((uint64_t)(key * HASH_MULTIPLIER)
+			>> dispatch->hashShift);
+}
+
+void
+McanDispatch_init(McanDispatch *const dispatch,
+		const McanDispatch_Config *const config)
+{
+	assert(dispatch != NULL);
+	assert(config != NULL);
+	assert(config->entryCount != 0u);
+	assert((config->entryCount & (config->entryCount - 1u)) == 0u);
+
+	memset(dispatch, 0, sizeof(McanDispatch));
+	dispatch->config = *config;
+
+	uint32_t bits = 0;
+	while ((1u << bits) < config->entryCount)
+		bits++;
+	dispatch->hashShift = 32u - bits;
+
+	memset(config->entries, 0,
+			config->entryCount * sizeof(McanDispatch_Entry));
+	if (config->standardFilterHandlers != NULL)
+		memset(config->standardFilterHandlers, 0,
+				config->standardFilterHandlerCount
+						* sizeof(McanDispatch_Handler));
+	if (config->extendedFilterHandlers != NULL)
+		memset(config->extendedFilterHandlers, 0,
+				config->extendedFilterHandlerCount
+						* sizeof(McanDispatch_Handler));
+}
+
+bool
+McanDispatch_addId(McanDispatch *const dispatch, const Mcan_IdType idType,
+		const uint32_t id, const McanDispatch_Handler handler,
+		int *const errCode)
+{
+	const uint32_t key = encodeKey(idType, id);
+	const uint32_t mask = dispatch->config.entryCount - 1u;
+	uint32_t index = getHomeIndex(dispatch, key);
+
+	for (uint32_t probe = 1; probe <= dispatch->config.entryCount;
+			probe++) {
+		McanDispatch_Entry *const entry =
+				&dispatch->config.entries[index];
+		if ((entry->key == 0u) || (entry->key == key)) {
+			if (entry->key == 0u)
+				dispatch->idCount++;
+			entry->key = key;
+			entry->handler = handler;
+			if (probe > dispatch->maxProbeLength)
+				dispatch->maxProbeLength = probe;
+			return true;
+		}
+		index = (index + 1u) & mask;
+	}
+
+	return returnError(errCode, McanDispatch_ErrorCodes_TableFull);
+}
+
+bool
+McanDispatch_setFilterHandler(McanDispatch *const dispatch,
+		const Mcan_IdType idType, const uint8_t filterIndex,
+		const McanDispatch_Handler handler, int *const errCode)
+{
+	McanDispatch_Handler *const handlers = (idType == Mcan_IdType_Standard)
+			? dispatch->config.standardFilterHandlers
+			: dispatch->config.extendedFilterHandlers;
+	const uint32_t count = (idType == Mcan_IdType_Standard)
+			? dispatch->config.standardFilterHandlerCount
+			: dispatch->config.extendedFilterHandlerCount;
+	if ((handlers == NULL) || (filterIndex >= count))
+		return returnError(errCode,
+				McanDispatch_ErrorCodes_IndexOutOfRange);
+
+	handlers[filterIndex] = handler;
+	return true;
+}
+
+void
+McanDispatch_setDefaultHandler(
+		McanDispatch *const dispatch, const McanDispatch_Handler handler)
+{
+	dispatch->defaultHandler = handler;
+}
+
+const McanDispatch_Handler *
+McanDispatch_findId(const McanDispatch *const dispatch,
+		const Mcan_IdType idType, const uint32_t id)
+{
+	const uint32_t key = encodeKey(idType, id);
+	const uint32_t mask = dispatch->config.entryCount - 1u;
+	uint32_t index = getHomeIndex(dispatch, key);
+
+	// No identifier is stored further than the longest probe sequence
+	// from its home index, which bounds the lookup.
+	for (uint32_t probe = 0; probe < dispatch->maxProbeLength; probe++) {
+		const McanDispatch_Entry *const entry =
+				&dispatch->config.entries[index];
+		if (entry->key == key)
+			return &entry->handler;
+		if (entry->key == 0u)
+			return NULL;
+		index = (index + 1u) & mask;
+	}
+	return NULL;
+}
+
+static const McanDispatch_Handler *
+findFilterHandler(const McanDispatch *const dispatch,
+		const Mcan_RxElement *const element)
+{
+	if (element->isNonMatchingFrame)
+		return NULL;
+
+	const McanDispatch_Handler *handlers;
+	uint32_t count;
+	if (element->idType == Mcan_IdType_Standard) {
+		handlers = dispatch->config.standardFilterHandlers;
+		count = dispatch->config.standardFilterHandlerCount;
+	} else {
+		handlers = dispatch->config.extendedFilterHandlers;
+		count = dispatch->config.extendedFilterHandlerCount;
+	}
+	if ((handlers == NULL) || (element->filterIndex >= count)
+			|| (handlers[element->filterIndex].callback == NULL))
+		return NULL;
+	return &handlers[element->filterIndex];
+}
+
+bool
+McanDispatch_dispatch(const McanDispatch *const dispatch,
+		const Mcan_RxElement *const element)
+{
+	const McanDispatch_Handler *handler =
+			findFilterHandler(dispatch, element);
+	if (handler == NULL)
+		handler = McanDispatch_findId(
+				dispatch, element->idType, element->id);
+	if ((handler == NULL) || (handler->callback == NULL))
+		handler = &dispatch->defaultHandler;
+	if (handler->callback == NULL)
+		return false;
+
+	handler->callback(element, handler->arg);
+	return true;
+}
@@ -0,0 +1,149 @@
+/**@file
+ * This file is part of the ARM BSP for the Test Environment.
+ *
+ * @copyright 2020-2021 N7 Space Sp. z o.o.
+ *
+ * Test Environment was developed under a programme of,
+ * and funded by, the European Space Agency (the "ESA").
+ *
+ *
+ * Licensed under the ESA Public License (ESA-PL) Permissive,
+ * Version 2.3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://essr.esa.int/license/list
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @defgroup McanDispatch McanDispatch
+ * @ingroup Mcan
+ * @{
+ */
+
+#ifndef BSP_MCAN_DISPATCH_H
+#define BSP_MCAN_DISPATCH_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "Mcan.h"
+
+/// \brief Dispatcher error codes.
+typedef enum {
+	/// \brief The identifier table is full.
+	McanDispatch_ErrorCodes_TableFull = 1,
+	/// \brief Filter index exceeds the size of the filter handler table.
+	McanDispatch_ErrorCodes_IndexOutOfRange = 2,
+} McanDispatch_ErrorCodes;
+
+/// \brief A function serving as a callback called for a dispatched Rx element.
+typedef void (*McanDispatchCallback)(
+		const Mcan_RxElement *const element, void *arg);
+
+/// \brief A descriptor of an Rx element handler.
+typedef struct {
+	McanDispatchCallback callback; ///< Callback function.
+	void *arg; ///< Argument to the callback function.
+} McanDispatch_Handler;
+
+/// \brief Identifier table entry.
+typedef struct {
+	uint32_t key; ///< Encoded identifier and its type; 0 for an empty entry.
+	McanDispatch_Handler handler; ///< Handler of the identifier.
+} McanDispatch_Entry;
+
+/// \brief Storage used by the dispatcher, provided by the user.
+typedef struct {
+	/// \brief Identifier table; the entry count shall be a power of 2, and
+	///        should be at least twice the number of identifiers to keep the
+	///        probe sequences short.
+	McanDispatch_Entry *entries;
+	uint32_t entryCount; ///< Number of entries in the identifier table.
+	/// \brief Handlers indexed by the standard Id filter index; can be NULL.
+	McanDispatch_Handler *standardFilterHandlers;
+	/// \brief Number of standard Id filter handlers.
+	uint32_t standardFilterHandlerCount;
+	/// \brief Handlers indexed by the extended Id filter index; can be NULL.
+	McanDispatch_Handler *extendedFilterHandlers;
+	/// \brief Number of extended Id filter handlers.
+	uint32_t extendedFilterHandlerCount;
+} McanDispatch_Config;
+
+/// \brief Rx element dispatcher descriptor.
+typedef struct {
+	McanDispatch_Config config; ///< Dispatcher storage.
+	uint32_t hashShift; ///< Shift selecting the table index from the hash.
+	uint32_t idCount; ///< Number of identifiers in the table.
+	/// \brief Length of the longest probe sequence in the table, bounding
+	///        the cost of a lookup.
+	uint32_t maxProbeLength;
+	/// \brief Handler of elements matching no filter handler and identifier.
+	McanDispatch_Handler defaultHandler;
+} McanDispatch;
+
+/// \brief Initializes a dispatcher, clearing the provided tables.
+/// \param [out] dispatch Dispatcher descriptor.
+/// \param [in] config Dispatcher storage.
+void McanDispatch_init(McanDispatch *const dispatch,
+		const McanDispatch_Config *const config);
+
+/// \brief Adds an identifier to the table, or replaces its handler.
+/// \param [in] dispatch Dispatcher descriptor.
+/// \param [in] idType Type of the identifier.
+/// \param [in] id Identifier.
+/// \param [in] handler Handler of the identifier.
+/// \param [out] errCode An error code generated during the operation.
+/// \retval true Adding the identifier was successful.
+/// \retval false Adding the identifier failed.
+bool McanDispatch_addId(McanDispatch *const dispatch, const Mcan_IdType idType,
+		const uint32_t id, const McanDispatch_Handler handler,
+		int *const errCode);
+
+/// \brief Sets the handler of elements accepted by a hardware filter. Filter
+///        handlers take precedence over the identifier table.
+/// \param [in] dispatch Dispatcher descriptor.
+/// \param [in] idType Type of the filter list.
+/// \param [in] filterIndex Index of the filter element.
+/// \param [in] handler Handler of the filter; a NULL callback removes it.
+/// \param [out] errCode An error code generated during the operation.
+/// \retval true Setting the handler was successful.
+/// \retval false Setting the handler failed.
+bool McanDispatch_setFilterHandler(McanDispatch *const dispatch,
+		const Mcan_IdType idType, const uint8_t filterIndex,
+		const McanDispatch_Handler handler, int *const errCode);
+
+/// \brief Sets the handler of elements not handled otherwise.
+/// \param [in] dispatch Dispatcher descriptor.
+/// \param [in] handler Default handler; a NULL callback removes it.
+void McanDispatch_setDefaultHandler(
+		McanDispatch *const dispatch, const McanDispatch_Handler handler);
+
+/// \brief Looks up the handler of an identifier in the table.
+/// \param [in] dispatch Dispatcher descriptor.
+/// \param [in] idType Type of the identifier.
+/// \param [in] id Identifier.
+/// \returns Handler of the identifier, or NULL if not found.
+const McanDispatch_Handler *McanDispatch_findId(
+		const McanDispatch *const dispatch, const Mcan_IdType idType,
+		const uint32_t id);
+
+/// \brief Calls the handler of an Rx element: the handler of the accepting
+///        filter if set, otherwise the handler of its identifier, otherwise
+///        the default handler.
+/// \param [in] dispatch Dispatcher descriptor.
+/// \param [in] element Rx element.
+/// \retval true A handler was called.
+/// \retval false No handler was found.
+bool McanDispatch_dispatch(const McanDispatch *const dispatch,
+		const Mcan_RxElement *const element);
+
+#endif // BSP_MCAN_DISPATCH_H
+
+/** @} */
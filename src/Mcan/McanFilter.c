@@ -0,0 +1,279 @@
+/**@file
+ * This file is part of the ARM BSP for the Test Environment.
+ *
+ * @copyright 2020-2021 N7 Space Sp. z o.o.
+ *
+ * Test Environment was developed under a programme of,
+ * and funded by, the European Space Agency (the "ESA").
+ *
+ *
+ * Licensed under the ESA Public License (ESA-PL) Permissive,
+ * Version 2.3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://essr.esa.int/license/list
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "McanFilter.h"
+
+#include <assert.h>
+#include <stddef.h>
+
+#include <Utils/Utils.h>
+
+/// \brief Numbers of range and single identifier entries per Rx FIFO.
+typedef struct {
+	uint32_t ranges[2];
+	uint32_t singles[2];
+} EntryCounts;
+
+static uint32_t
+getElementCount(const EntryCounts *const counts)
+{
+	// Single identifiers are paired into dual filter elements.
+	return counts->ranges[0] + counts->ranges[1]
+			+ ((counts->singles[0] + 1u) / 2u)
+			+ ((counts->singles[1] + 1u) / 2u);
+}
+
+static void
+countEntry(EntryCounts *const counts, const McanFilter_IdRange *const range,
+		const int32_t delta)
+{
+	uint32_t *const counter = (range->first == range->last)
+			? &counts->singles[range->fifo]
+			: &counts->ranges[range->fifo];
+	*counter = (uint32_t)((int32_t)*counter + delta);
+}
+
+static void
+sortRanges(McanFilter_IdRange *const ranges, const uint32_t count)
+{
+	for (uint32_t i = 1; i < count; i++) {
+		const McanFilter_IdRange range = ranges[i];
+		uint32_t j = i;
+		while ((j > 0u) && (ranges[j - 1u].first > range.first)) {
+			ranges[j] = ranges[j - 1u];
+			j--;
+		}
+		ranges[j] = range;
+	}
+}
+
+static void
+removeRange(McanFilter_IdRange *const ranges, const uint32_t count,
+		const uint32_t index)
+{
+	for (uint32_t i = index; (i + 1u) < count; i++)
+		ranges[i] = ranges[i + 1u];
+}
+
+static bool
+coalesceRanges(McanFilter_IdRange *const ranges, uint32_t *const count,
+		int *const errCode)
+{
+	uint32_t i = 0;
+	while ((i + 1u) < *count) {
+		McanFilter_IdRange *const range = &ranges[i];
+		const McanFilter_IdRange *const next = &ranges[i + 1u];
+		const bool isOverlapping = next->first <= range->last;
+		if (isOverlapping && (next->fifo != range->fifo))
+			return returnError(errCode,
+					McanFilter_ErrorCodes_ConflictingRouting);
+		if (isOverlapping || ((next->fifo == range->fifo)
+						     && (next->first
+								     == (range->last
+										     + 1u)))) {
+			if (next->last > range->last)
+				range->last = next->last;
+			removeRange(ranges, *count, i + 1u);
+			(*count)--;
+		} else {
+			i++;
+		}
+	}
+	return true;
+}
+
+static bool
+findMerge(const McanFilter_IdRange *const ranges, const uint32_t count,
+		const EntryCounts *const counts, uint32_t *const mergeIndex)
+{
+	const uint32_t elementCount = getElementCount(counts);
+	bool isFound = false;
+	bool isReducing = false;
+	uint32_t bestGap = UINT32_MAX;
+
+	for (uint32_t i = 0; (i + 1u) < count; i++) {
+		const McanFilter_IdRange *const range = &ranges[i];
+		const McanFilter_IdRange *const next = &ranges[i + 1u];
+		if (range->fifo != next->fifo)
+			continue;
+
+		EntryCounts merged = *counts;
+		countEntry(&merged, range, -1);
+		countEntry(&merged, next, -1);
+		merged.ranges[range->fifo]++;
+		// Prefer merges which save a filter element; merging two single
+		// identifiers does not, but can enable such merges later.
+		const bool isMergeReducing =
+				getElementCount(&merged) < elementCount;
+		const uint32_t gap = next->first - range->last - 1u;
+
+		if ((isMergeReducing && !isReducing)
+				|| ((isMergeReducing == isReducing)
+						&& (gap < bestGap))) {
+			isFound = true;
+			isReducing = isMergeReducing;
+			bestGap = gap;
+			*mergeIndex = i;
+		}
+	}
+	return isFound;
+}
+
+static Mcan_RxFilterConfig
+getFilterConfig(const Mcan_RxFifoId fifo)
+{
+	return (fifo == Mcan_RxFifoId_0) ? Mcan_RxFilterConfig_RxFifo0
+					 : Mcan_RxFilterConfig_RxFifo1;
+}
+
+static uint32_t
+emitElements(const McanFilter_IdRange *const ranges, const uint32_t count,
+		Mcan_RxFilterElement *const elements)
+{
+	uint32_t elementCount = 0;
+	const McanFilter_IdRange *pendingSingles[2] = { NULL, NULL };
+
+	for (uint32_t i = 0; i < count; i++) {
+		const McanFilter_IdRange *const range = &ranges[i];
+		Mcan_RxFilterElement *const element = &elements[elementCount];
+
+		if (range->first != range->last) {
+			element->config = getFilterConfig(range->fifo);
+			element->type = Mcan_RxFilterType_Range;
+			element->id1 = range->first;
+			element->id2 = range->last;
+			elementCount++;
+		} else if (pendingSingles[range->fifo] == NULL) {
+			pendingSingles[range->fifo] = range;
+		} else {
+			element->config = getFilterConfig(range->fifo);
+			element->type = Mcan_RxFilterType_Dual;
+			element->id1 = pendingSingles[range->fifo]->first;
+			element->id2 = range->first;
+			pendingSingles[range->fifo] = NULL;
+			elementCount++;
+		}
+	}
+
+	for (uint32_t fifo = 0; fifo < 2u; fifo++) {
+		if (pendingSingles[fifo] == NULL)
+			continue;
+		Mcan_RxFilterElement *const element = &elements[elementCount];
+		element->type = Mcan_RxFilterType_Dual;
+		element->config = getFilterConfig((Mcan_RxFifoId)fifo);
+		element->id1 = pendingSingles[fifo]->first;
+		element->id2 = pendingSingles[fifo]->first;
+		elementCount++;
+	}
+	return elementCount;
+}
+
+bool
+McanFilter_compile(McanFilter_IdRange *const ranges, const uint32_t rangeCount,
+		const Mcan_IdType idType, Mcan_RxFilterElement *const elements,
+		const uint32_t maxElements, McanFilter_Report *const report,
+		int *const errCode)
+{
+	assert((ranges != NULL) || (rangeCount == 0u));
+	assert(elements != NULL);
+
+	const uint32_t maxId = (idType == Mcan_IdType_Standard)
+			? MCAN_FILTER_MAX_STANDARD_ID
+			: MCAN_FILTER_MAX_EXTENDED_ID;
+	for (uint32_t i = 0; i < rangeCount; i++)
+		if ((ranges[i].first > ranges[i].last) || (ranges[i].last > maxId)
+				|| (ranges[i].fifo > Mcan_RxFifoId_1))
+			return returnError(errCode,
+					McanFilter_ErrorCodes_InvalidId);
+
+	uint32_t count = rangeCount;
+	sortRanges(ranges, count);
+	if (!coalesceRanges(ranges, &count, errCode))
+		return false;
+
+	EntryCounts counts = { { 0, 0 }, { 0, 0 } };
+	uint32_t requestedIdCount = 0;
+	for (uint32_t i = 0; i < count; i++) {
+		countEntry(&counts, &ranges[i], 1);
+		requestedIdCount += ranges[i].last - ranges[i].first + 1u;
+	}
+
+	uint32_t falseAcceptedIdCount = 0;
+	while (getElementCount(&counts) > maxElements) {
+		uint32_t index = 0;
+		if (!findMerge(ranges, count, &counts, &index))
+			return returnError(errCode,
+					McanFilter_ErrorCodes_TooManyFilters);
+		McanFilter_IdRange *const range = &ranges[index];
+		const McanFilter_IdRange *const next = &ranges[index + 1u];
+		countEntry(&counts, range, -1);
+		countEntry(&counts, next, -1);
+		falseAcceptedIdCount += next->first - range->last - 1u;
+		range->last = next->last;
+		countEntry(&counts, range, 1);
+		removeRange(ranges, count, index + 1u);
+		count--;
+	}
+
+	const uint32_t elementCount = emitElements(ranges, count, elements);
+	assert(elementCount == getElementCount(&counts));
+
+	if (report != NULL) {
+		report->elementCount = elementCount;
+		report->requestedIdCount = requestedIdCount;
+		report->falseAcceptedIdCount = falseAcceptedIdCount;
+		report->unrequestedIdCount = maxId + 1u - requestedIdCount;
+	}
+	return true;
+}
+
+bool
+McanFilter_program(Mcan *const mcan, const Mcan_IdType idType,
+		const Mcan_RxFilterElement *const elements,
+		const uint32_t elementCount, int *const errCode)
+{
+	const uint32_t listSize = (idType == Mcan_IdType_Standard)
+			? mcan->rxStdFilterSize
+			: mcan->rxExtFilterSize;
+	if (elementCount > listSize)
+		return returnError(errCode, Mcan_ErrorCodes_IndexOutOfRange);
+
+	const Mcan_RxFilterElement disabled = {
+		.type = Mcan_RxFilterType_Dual,
+		.config = Mcan_RxFilterConfig_Disabled,
+		.id1 = 0,
+		.id2 = 0,
+	};
+	for (uint32_t i = 0; i < listSize; i++) {
+		const Mcan_RxFilterElement element =
+				(i < elementCount) ? elements[i] : disabled;
+		const bool isSet = (idType == Mcan_IdType_Standard)
+				? Mcan_setStandardIdFilter(mcan, element,
+						  (uint8_t)i, errCode)
+				: Mcan_setExtendedIdFilter(mcan, element,
+						  (uint8_t)i, errCode);
+		if (!isSet)
+			return false;
+	}
+	return true;
+}
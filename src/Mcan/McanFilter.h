@@ -0,0 +1,115 @@
+/**@file
+ * This file is part of the ARM BSP for the Test Environment.
+ *
+ * @copyright 2020-2021 N7 Space Sp. z o.o.
+ *
+ * Test Environment was developed under a programme of,
+ * and funded by, the European Space Agency (the "ESA").
+ *
+ *
+ * Licensed under the ESA Public License (ESA-PL) Permissive,
+ * Version 2.3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://essr.esa.int/license/list
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @defgroup McanFilter McanFilter
+ * @ingroup Mcan
+ * @{
+ */
+
+#ifndef BSP_MCAN_FILTER_H
+#define BSP_MCAN_FILTER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "Mcan.h"
+
+/// \brief Largest standard CAN identifier.
+#define MCAN_FILTER_MAX_STANDARD_ID 0x7FFu
+/// \brief Largest extended CAN identifier.
+#define MCAN_FILTER_MAX_EXTENDED_ID 0x1FFFFFFFu
+
+/// \brief Filter compiler error codes.
+typedef enum {
+	/// \brief An identifier exceeds the range of the identifier type or a
+	///        range is reversed.
+	McanFilter_ErrorCodes_InvalidId = 1,
+	/// \brief An identifier is routed to both Rx FIFOs.
+	McanFilter_ErrorCodes_ConflictingRouting = 2,
+	/// \brief The identifiers cannot be covered with the available number
+	///        of filter elements, even when accepting additional identifiers.
+	McanFilter_ErrorCodes_TooManyFilters = 3,
+} McanFilter_ErrorCodes;
+
+/// \brief A range of identifiers to be accepted into an Rx FIFO. A single
+///        identifier is described by equal first and last identifiers.
+typedef struct {
+	uint32_t first; ///< First accepted identifier.
+	uint32_t last; ///< Last accepted identifier.
+	Mcan_RxFifoId fifo; ///< Rx FIFO receiving the identifiers.
+} McanFilter_IdRange;
+
+/// \brief Result of a filter compilation.
+typedef struct {
+	uint32_t elementCount; ///< Number of produced filter elements.
+	uint32_t requestedIdCount; ///< Number of requested identifiers.
+	/// \brief Number of identifiers accepted by the produced filter
+	///        elements, but not requested.
+	uint32_t falseAcceptedIdCount;
+	/// \brief Number of identifiers of the identifier type which were not
+	///        requested, the base of the false accept rate.
+	uint32_t unrequestedIdCount;
+} McanFilter_Report;
+
+/// \brief Compiles a set of identifier ranges with their Rx FIFO routing into
+///        a minimal list of range and dual filter elements. Exact coverage
+///        is produced whenever it fits in maxElements; otherwise the closest
+///        ranges routed to the same Rx FIFO are merged, accepting the fewest
+///        unrequested identifiers, until the list fits. Ranges are never
+///        merged across identifiers routed to the other Rx FIFO. The
+///        function does not access the hardware and can be used both on the
+///        target and offline. Non-matching frames should be rejected with
+///        Mcan_NonMatchingPolicy_Rejected.
+/// \param [in,out] ranges Requested identifier ranges; sorted and coalesced in
+///        place.
+/// \param [in] rangeCount Number of requested ranges.
+/// \param [in] idType Type of the identifiers.
+/// \param [out] elements Produced filter elements.
+/// \param [in] maxElements Capacity of the elements array, e.g. the size of the
+///        filter list.
+/// \param [out] report Compilation report; can be NULL.
+/// \param [out] errCode An error code generated during the operation.
+/// \retval true Compilation was successful.
+/// \retval false Compilation failed.
+bool McanFilter_compile(McanFilter_IdRange *const ranges,
+		const uint32_t rangeCount, const Mcan_IdType idType,
+		Mcan_RxFilterElement *const elements, const uint32_t maxElements,
+		McanFilter_Report *const report, int *const errCode);
+
+/// \brief Writes filter elements into the standard or extended Id filter list
+///        of the device and disables the remaining elements of the list.
+/// \param [in] mcan Mcan device descriptor.
+/// \param [in] idType Type of the identifiers, selecting the filter list.
+/// \param [in] elements Filter elements.
+/// \param [in] elementCount Number of filter elements.
+/// \param [out] errCode An error code generated during the operation.
+/// \retval true Programming was successful.
+/// \retval false Programming failed.
+bool McanFilter_program(Mcan *const mcan, const Mcan_IdType idType,
+		const Mcan_RxFilterElement *const elements,
+		const uint32_t elementCount, int *const errCode);
+
+#endif // BSP_MCAN_FILTER_H
+
+/** @} */
@@ -0,0 +1,191 @@
+/**@file
+ * This file is part of the ARM BSP for the Test Environment.
+ *
+ * @copyright 2020-2021 N7 Space Sp. z o.o.
+ *
+ * Test Environment was developed under a programme of,
+ * and funded by, the European Space Agency (the "ESA").
+ *
+ *
+ * Licensed under the ESA Public License (ESA-PL) Permissive,
+ * Version 2.3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://essr.esa.int/license/list
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "McanGateway.h"
+
+#include <assert.h>
+#include <stddef.h>
+#include <string.h>
+
+#define TX_ELEMENT_HEADER_SIZE (MCAN_TXELEMENT_DATA_WORD * 4u)
+#define FORWARDED_T1_MASK                                                     \
+	(MCAN_TXELEMENT_DLC_MASK | MCAN_TXELEMENT_BRS_MASK                     \
+			| MCAN_TXELEMENT_FDF_MASK)
+
+typedef enum {
+	FrameStatus_Forwarded,
+	FrameStatus_Filtered,
+	FrameStatus_Dropped,
+} FrameStatus;
+
+void
+McanGateway_init(McanGateway *const gateway,
+		const McanGateway_Config *const config)
+{
+	gateway->config = *config;
+	McanGateway_resetStats(gateway);
+}
+
+void
+McanGateway_resetStats(McanGateway *const gateway)
+{
+	memset(gateway->stats, 0, sizeof(gateway->stats));
+}
+
+static const McanGateway_Route *
+findRoute(const McanGateway *const gateway,
+		const McanGateway_Direction direction, const Mcan_IdType idType,
+		const uint32_t id)
+{
+	for (uint32_t i = 0; i < gateway->config.routeCount; i++) {
+		const McanGateway_Route *const route = &gateway->config.routes[i];
+		if ((route->direction == direction) && (route->idType == idType)
+				&& (id >= route->firstId)
+				&& (id <= route->lastId))
+			return route;
+	}
+	return NULL;
+}
+
+static uint32_t
+encodeHeader(const McanGateway_Route *const route, const Mcan_IdType idType,
+		const uint32_t id, const uint32_t header)
+{
+	// The gateway itself is error active, so ESI is always dominant.
+	const uint32_t word = header & ~MCAN_TXELEMENT_ESI_MASK;
+	if (route->idMask == 0u)
+		return word;
+
+	const uint32_t newId = (id & ~route->idMask)
+			| (route->idValue & route->idMask);
+	if (idType == Mcan_IdType_Standard)
+		return (word & ~MCAN_TXELEMENT_STDID_MASK)
+				| ((newId << MCAN_TXELEMENT_STDID_OFFSET)
+						& MCAN_TXELEMENT_STDID_MASK);
+	return (word & ~MCAN_TXELEMENT_EXTID_MASK)
+			| ((newId << MCAN_TXELEMENT_EXTID_OFFSET)
+					& MCAN_TXELEMENT_EXTID_MASK);
+}
+
+static void
+checkMessageLost(Mcan *const source, const Mcan_RxFifoId fifo,
+		McanGateway_Stats *const stats)
+{
+	const uint32_t mask = (fifo == Mcan_RxFifoId_0) ? MCAN_IR_RF0L_MASK
+							: MCAN_IR_RF1L_MASK;
+	if ((source->reg->ir & mask) != 0u) {
+		source->reg->ir = mask;
+		stats->lostCount++;
+	}
+}
+
+uint32_t
+McanGateway_forward(
+		McanGateway *const gateway, const McanGateway_Direction direction)
+{
+	assert(direction < McanGateway_Direction_Count);
+
+	Mcan *const source = gateway->config.mcan[direction];
+	Mcan *const destination = gateway->config.mcan[direction ^ 1u];
+	const Mcan_RxFifoId fifo = gateway->config.rxFifo[direction];
+	McanGateway_Stats *const stats = &gateway->stats[direction];
+
+	checkMessageLost(source, fifo, stats);
+
+	Mcan_RxElementView views[MCAN_GATEWAY_BATCH_SIZE];
+	uint32_t viewCount = 0;
+	int errCode = 0;
+	if (!Mcan_rxFifoPeekBatch(source, fifo, views, MCAN_GATEWAY_BATCH_SIZE,
+			    &viewCount, &errCode))
+		return 0;
+	const uint16_t now = (uint16_t)((source->reg->tscv & MCAN_TSCV_TSC_MASK)
+			>> MCAN_TSCV_TSC_OFFSET);
+	const uint32_t maxDataSize =
+			destination->txElementSize - TX_ELEMENT_HEADER_SIZE;
+
+	FrameStatus statuses[MCAN_GATEWAY_BATCH_SIZE];
+	Mcan_TxTemplate templates[MCAN_GATEWAY_BATCH_SIZE];
+	const uint8_t *data[MCAN_GATEWAY_BATCH_SIZE];
+	uint8_t viewIndexes[MCAN_GATEWAY_BATCH_SIZE];
+	uint32_t frameCount = 0;
+	for (uint32_t i = 0; i < viewCount; i++) {
+		const Mcan_RxElementView *const view = &views[i];
+		const Mcan_IdType idType = Mcan_rxViewGetIdType(view);
+		const uint32_t id = Mcan_rxViewGetId(view);
+		const McanGateway_Route *const route =
+				findRoute(gateway, direction, idType, id);
+		if (route == NULL) {
+			statuses[i] = FrameStatus_Filtered;
+			continue;
+		}
+		const uint8_t dataSize = Mcan_rxViewGetDataSize(view);
+		if (dataSize > maxDataSize) {
+			statuses[i] = FrameStatus_Dropped;
+			continue;
+		}
+
+		// Rx and Tx element headers share the layout of the identifier,
+		// flags and DLC fields, so they are copied without decoding.
+		Mcan_TxTemplate *const tmpl = &templates[frameCount];
+		tmpl->header[0] = encodeHeader(route, idType, id,
+				view->address[MCAN_RXELEMENT_ESI_WORD]);
+		tmpl->header[1] = view->address[MCAN_RXELEMENT_DLC_WORD]
+				& FORWARDED_T1_MASK;
+		tmpl->dataSize = dataSize;
+		tmpl->isInterruptEnabled = false;
+		data[frameCount] = Mcan_rxViewGetData(view);
+		viewIndexes[frameCount] = (uint8_t)i;
+		statuses[i] = FrameStatus_Forwarded;
+		frameCount++;
+	}
+
+	uint32_t pushedCount = 0;
+	if (frameCount != 0u)
+		(void)Mcan_txQueuePushTemplateBatch(destination, templates, data,
+				frameCount, &pushedCount, &errCode);
+
+	// Frames which did not fit into the Tx Queue stay in the Rx FIFO,
+	// together with all frames received after them.
+	const uint32_t consumedCount = (pushedCount == frameCount)
+			? viewCount
+			: viewIndexes[pushedCount];
+	for (uint32_t i = 0; i < consumedCount; i++) {
+		switch (statuses[i]) {
+		case FrameStatus_Forwarded: {
+			const uint16_t latency = (uint16_t)(
+					now - Mcan_rxViewGetTimestamp(&views[i]));
+			if (latency > stats->latencyMax)
+				stats->latencyMax = latency;
+			stats->latencySum += latency;
+			stats->forwardedCount++;
+			break;
+		}
+		case FrameStatus_Filtered: stats->filteredCount++; break;
+		case FrameStatus_Dropped: stats->droppedCount++; break;
+		}
+	}
+	if (consumedCount != 0u)
+		Mcan_rxFifoRelease(source, &views[consumedCount - 1u]);
+
+	return pushedCount;
+}
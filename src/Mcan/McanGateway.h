@@ -0,0 +1,122 @@
+/**@file
+ * This file is part of the ARM BSP for the Test Environment.
+ *
+ * @copyright 2020-2021 N7 Space Sp. z o.o.
+ *
+ * Test Environment was developed under a programme of,
+ * and funded by, the European Space Agency (the "ESA").
+ *
+ *
+ * Licensed under the ESA Public License (ESA-PL) Permissive,
+ * Version 2.3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://essr.esa.int/license/list
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @defgroup McanGateway McanGateway
+ * @ingroup Mcan
+ * @{
+ */
+
+#ifndef BSP_MCAN_GATEWAY_H
+#define BSP_MCAN_GATEWAY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "Mcan.h"
+
+/// \brief Maximum number of frames forwarded by a single McanGateway_forward
+///        call.
+#define MCAN_GATEWAY_BATCH_SIZE 16u
+
+/// \brief Forwarding direction.
+typedef enum {
+	McanGateway_Direction_0To1 = 0, ///< From the first to the second device.
+	McanGateway_Direction_1To0 = 1, ///< From the second to the first device.
+	McanGateway_Direction_Count = 2, ///< Number of directions.
+} McanGateway_Direction;
+
+/// \brief Routing table entry. Frames with identifiers within the range are
+///        forwarded, with the identifier bits selected by idMask replaced by
+///        the corresponding bits of idValue.
+typedef struct {
+	McanGateway_Direction direction; ///< Forwarding direction.
+	Mcan_IdType idType; ///< Identifier type.
+	uint32_t firstId; ///< First identifier of the range.
+	uint32_t lastId; ///< Last identifier of the range.
+	uint32_t idMask; ///< Rewritten identifier bits; 0 - no rewrite.
+	uint32_t idValue; ///< Values of the rewritten identifier bits.
+} McanGateway_Route;
+
+/// \brief Gateway configuration.
+typedef struct {
+	/// \brief Connected Mcan devices. Frames are received from the Rx FIFOs
+	///        and sent via the Tx Queues of the devices.
+	Mcan *mcan[McanGateway_Direction_Count];
+	/// \brief Rx FIFO of each device holding the frames to be forwarded.
+	Mcan_RxFifoId rxFifo[McanGateway_Direction_Count];
+	/// \brief Routing table, searched in order; the first matching entry
+	///        is used.
+	const McanGateway_Route *routes;
+	uint32_t routeCount; ///< Number of routing table entries.
+} McanGateway_Config;
+
+/// \brief Forwarding statistics of a single direction.
+typedef struct {
+	uint32_t forwardedCount; ///< Number of forwarded frames.
+	uint32_t filteredCount; ///< Number of frames without a matching route.
+	/// \brief Number of frames too large for the destination Tx elements.
+	uint32_t droppedCount;
+	/// \brief Number of Rx FIFO message lost events; each means at least
+	///        one frame was lost, e.g. when the destination stays congested.
+	uint32_t lostCount;
+	/// \brief Maximum time between reception and submission for
+	///        transmission, in source timestamp counter ticks.
+	uint16_t latencyMax;
+	/// \brief Sum of forwarding latencies of all forwarded frames, in
+	///        source timestamp counter ticks.
+	uint64_t latencySum;
+} McanGateway_Stats;
+
+/// \brief Gateway descriptor.
+typedef struct {
+	McanGateway_Config config; ///< Configuration.
+	McanGateway_Stats stats[McanGateway_Direction_Count]; ///< Statistics.
+} McanGateway;
+
+/// \brief Initializes the gateway.
+/// \param [out] gateway Gateway descriptor.
+/// \param [in] config Gateway configuration.
+void McanGateway_init(McanGateway *const gateway,
+		const McanGateway_Config *const config);
+
+/// \brief Forwards up to MCAN_GATEWAY_BATCH_SIZE frames in the given
+///        direction. The raw element words are copied from the source Rx
+///        FIFO to the destination Tx Queue without decoding, and the whole
+///        batch is submitted at once. Frames which do not fit into the
+///        destination Tx Queue are left in the Rx FIFO for the next call.
+///        Latency is measured using the source timestamp counter, which shall
+///        be enabled; the Rx FIFO message lost flag of the source is cleared.
+/// \param [in] gateway Gateway descriptor.
+/// \param [in] direction Forwarding direction.
+/// \returns Number of forwarded frames.
+uint32_t McanGateway_forward(
+		McanGateway *const gateway, const McanGateway_Direction direction);
+
+/// \brief Resets the statistics of both directions.
+/// \param [in] gateway Gateway descriptor.
+void McanGateway_resetStats(McanGateway *const gateway);
+
+#endif // BSP_MCAN_GATEWAY_H
+
+/** @} */
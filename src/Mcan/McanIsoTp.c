@@ -0,0 +1,525 @@
+/**@file
+ * This file is part of the ARM BSP for the Test Environment.
+ *
+ * @copyright 2020-2021 N7 Space Sp. z o.o.
+ *
+ * Test Environment was developed under a programme of,
+ * and funded by, the European Space Agency (the "ESA").
+ *
+ *
+ * Licensed under the ESA Public License (ESA-PL) Permissive,
+ * Version 2.3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://essr.esa.int/license/list
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "McanIsoTp.h"
+
+#include <assert.h>
+#include <stddef.h>
+#include <string.h>
+
+#include <Utils/Utils.h>
+
+#define PCI_TYPE_OFFSET 4u
+#define PCI_LOW_MASK 0x0Fu
+#define PCI_SINGLE_FRAME 0x0u
+#define PCI_FIRST_FRAME 0x1u
+#define PCI_CONSECUTIVE_FRAME 0x2u
+#define PCI_FLOW_CONTROL 0x3u
+
+#define FLOW_STATUS_CONTINUE 0x0u
+#define FLOW_STATUS_WAIT 0x1u
+#define FLOW_STATUS_OVERFLOW 0x2u
+
+#define CLASSIC_FRAME_SIZE 8u
+#define FD_FRAME_SIZE 64u
+#define FLOW_CONTROL_SIZE 3u
+#define SHORT_FIRST_FRAME_MAX_SIZE 0xFFFu
+#define SEQUENCE_MASK 0x0Fu
+
+#define STMIN_MAX_MS 0x7Fu
+#define STMIN_US_FIRST 0xF1u
+#define STMIN_US_LAST 0xF9u
+#define STMIN_US_STEP 100u
+#define MICROSECONDS_PER_MILLISECOND 1000u
+
+static inline bool
+isTimeReached(const uint32_t now, const uint32_t time)
+{
+	return (int32_t)(now - time) >= 0;
+}
+
+static uint32_t
+decodeStMin(const uint8_t stMin)
+{
+	if (stMin <= STMIN_MAX_MS)
+		return stMin * MICROSECONDS_PER_MILLISECOND;
+	if ((stMin >= STMIN_US_FIRST) && (stMin <= STMIN_US_LAST))
+		return (stMin - STMIN_US_FIRST + 1u) * STMIN_US_STEP;
+	// Reserved values shall be handled as the maximum separation time.
+	return STMIN_MAX_MS * MICROSECONDS_PER_MILLISECOND;
+}
+
+static uint8_t
+getFdFrameSize(const uint32_t size)
+{
+	static const uint8_t sizes[] = { 8u, 12u, 16u, 20u, 24u, 32u, 48u, 64u };
+	for (uint32_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+		if (size <= sizes[i])
+			return sizes[i];
+	return FD_FRAME_SIZE;
+}
+
+static void
+prepareTemplate(const McanIsoTp_Session *const session, const uint8_t dataSize,
+		Mcan_TxTemplate *const tmpl)
+{
+	const Mcan_TxElement element = {
+		.esiFlag = Mcan_ElementEsi_Dominant,
+		.idType = session->config.idType,
+		.frameType = Mcan_FrameType_Data,
+		.id = session->config.txId,
+		.marker = 0u,
+		.isTxEventStored = false,
+		.isCanFdFormatEnabled = session->config.isCanFd,
+		.isBitRateSwitchingEnabled =
+				session->config.isBitRateSwitchingEnabled,
+		.dataSize = dataSize,
+		.data = NULL,
+		.isInterruptEnabled = false,
+	};
+	Mcan_txTemplatePrepare(&element, tmpl);
+}
+
+/// \brief Pads the frame and pushes it to the Tx Queue. Classic frames are
+///        always padded to 8 bytes, CAN FD frames to the nearest valid size.
+static bool
+sendFrame(McanIsoTp *const isoTp, const McanIsoTp_Session *const session,
+		uint8_t *const frame, const uint32_t size, int *const errCode)
+{
+	const uint8_t frameSize = session->config.isCanFd
+			? getFdFrameSize(size)
+			: CLASSIC_FRAME_SIZE;
+	memset(&frame[size], session->config.paddingByte, frameSize - size);
+
+	uint8_t index = 0u;
+	if (frameSize == session->frameSize)
+		return Mcan_txQueuePushTemplate(isoTp->config.mcan,
+				&session->frameTemplate, frame, &index,
+				errCode);
+
+	Mcan_TxTemplate tmpl;
+	prepareTemplate(session, frameSize, &tmpl);
+	return Mcan_txQueuePushTemplate(
+			isoTp->config.mcan, &tmpl, frame, &index, errCode);
+}
+
+static bool
+sendFlowControl(McanIsoTp *const isoTp, McanIsoTp_Session *const session,
+		const uint8_t flowStatus)
+{
+	uint8_t frame[CLASSIC_FRAME_SIZE];
+	frame[0] = (uint8_t)((PCI_FLOW_CONTROL << PCI_TYPE_OFFSET) | flowStatus);
+	frame[1] = session->config.blockSize;
+	frame[2] = session->config.stMin;
+
+	int errCode = 0;
+	session->isFlowControlPending = !sendFrame(
+			isoTp, session, frame, FLOW_CONTROL_SIZE, &errCode);
+	session->pendingFlowStatus = flowStatus;
+	return !session->isFlowControlPending;
+}
+
+static uint8_t *
+acquireBuffer(McanIsoTp *const isoTp)
+{
+	if (isoTp->freeBufferMask == 0u)
+		return NULL;
+
+	const uint32_t index = (uint32_t)__builtin_ctz(isoTp->freeBufferMask);
+	isoTp->freeBufferMask &= ~(1u << index);
+	return &isoTp->config.poolMemory[index * isoTp->config.poolBufferSize];
+}
+
+void
+McanIsoTp_releaseBuffer(McanIsoTp *const isoTp, uint8_t *const buffer)
+{
+	const uint32_t index = (uint32_t)(buffer - isoTp->config.poolMemory)
+			/ isoTp->config.poolBufferSize;
+	assert(index < isoTp->config.poolBufferCount);
+	isoTp->freeBufferMask |= 1u << index;
+}
+
+static void
+finishTx(McanIsoTp_Session *const session, const McanIsoTp_Result result)
+{
+	session->txState = McanIsoTp_TxState_Idle;
+	session->txData = NULL;
+	if (session->config.txCallback != NULL)
+		session->config.txCallback(session, result, session->config.arg);
+}
+
+static void
+finishRx(McanIsoTp *const isoTp, McanIsoTp_Session *const session,
+		const McanIsoTp_Result result)
+{
+	uint8_t *buffer = session->rxBuffer;
+	session->rxState = McanIsoTp_RxState_Idle;
+	session->rxBuffer = NULL;
+	if ((result != McanIsoTp_Result_Ok) && (buffer != NULL)) {
+		McanIsoTp_releaseBuffer(isoTp, buffer);
+		buffer = NULL;
+	}
+	if (session->config.rxCallback != NULL)
+		session->config.rxCallback(session, result, buffer,
+				session->rxSize, session->config.arg);
+}
+
+static void
+resetSession(McanIsoTp *const isoTp, McanIsoTp_Session *const session)
+{
+	if (session->rxBuffer != NULL)
+		McanIsoTp_releaseBuffer(isoTp, session->rxBuffer);
+
+	session->txState = McanIsoTp_TxState_Idle;
+	session->txData = NULL;
+	session->rxState = McanIsoTp_RxState_Idle;
+	session->rxBuffer = NULL;
+	session->isFlowControlPending = false;
+}
+
+void
+McanIsoTp_init(McanIsoTp *const isoTp, const McanIsoTp_Config *const config)
+{
+	assert(config->poolBufferCount <= MCAN_ISO_TP_MAX_POOL_BUFFERS);
+
+	isoTp->config = *config;
+	isoTp->freeBufferMask = (config->poolBufferCount
+						== MCAN_ISO_TP_MAX_POOL_BUFFERS)
+			? UINT32_MAX
+			: (1u << config->poolBufferCount) - 1u;
+	memset(config->sessions, 0,
+			config->sessionCount * sizeof(McanIsoTp_Session));
+}
+
+bool
+McanIsoTp_configureSession(McanIsoTp *const isoTp, const uint32_t index,
+		const McanIsoTp_SessionConfig *const config, int *const errCode)
+{
+	if (index >= isoTp->config.sessionCount)
+		return returnError(errCode, McanIsoTp_ErrorCodes_InvalidSession);
+
+	McanIsoTp_Session *const session = &isoTp->config.sessions[index];
+	resetSession(isoTp, session);
+	session->config = *config;
+	session->isConfigured = true;
+	session->frameSize = config->isCanFd ? FD_FRAME_SIZE : CLASSIC_FRAME_SIZE;
+	prepareTemplate(session, session->frameSize, &session->frameTemplate);
+	return true;
+}
+
+McanIsoTp_Session *
+McanIsoTp_findSession(const McanIsoTp *const isoTp, const Mcan_IdType idType,
+		const uint32_t id)
+{
+	for (uint32_t i = 0; i < isoTp->config.sessionCount; i++) {
+		McanIsoTp_Session *const session = &isoTp->config.sessions[i];
+		if (session->isConfigured && (session->config.rxId == id)
+				&& (session->config.idType == idType))
+			return session;
+	}
+	return NULL;
+}
+
+bool
+McanIsoTp_send(McanIsoTp *const isoTp, McanIsoTp_Session *const session,
+		const uint8_t *const data, const uint32_t size,
+		const uint32_t now, int *const errCode)
+{
+	if (session->txState != McanIsoTp_TxState_Idle)
+		return returnError(errCode, McanIsoTp_ErrorCodes_SessionBusy);
+	if ((size == 0u)
+			|| (!session->config.isCanFd
+					&& (size > SHORT_FIRST_FRAME_MAX_SIZE)))
+		return returnError(errCode, McanIsoTp_ErrorCodes_InvalidSize);
+
+	uint8_t frame[FD_FRAME_SIZE];
+	const uint32_t frameSize = session->frameSize;
+
+	if (size < CLASSIC_FRAME_SIZE) {
+		frame[0] = (uint8_t)size;
+		memcpy(&frame[1], data, size);
+		if (!sendFrame(isoTp, session, frame, size + 1u, errCode))
+			return false;
+		finishTx(session, McanIsoTp_Result_Ok);
+		return true;
+	}
+	if (size <= frameSize - 2u) {
+		// CAN FD Single Frame with the length in the second byte.
+		frame[0] = 0u;
+		frame[1] = (uint8_t)size;
+		memcpy(&frame[2], data, size);
+		if (!sendFrame(isoTp, session, frame, size + 2u, errCode))
+			return false;
+		finishTx(session, McanIsoTp_Result_Ok);
+		return true;
+	}
+
+	uint32_t headerSize = 2u;
+	if (size <= SHORT_FIRST_FRAME_MAX_SIZE) {
+		frame[0] = (uint8_t)((PCI_FIRST_FRAME << PCI_TYPE_OFFSET)
+				| (size >> 8u));
+		frame[1] = (uint8_t)size;
+	} else {
+		// First Frame with a 32-bit length, used by CAN FD only.
+		frame[0] = (uint8_t)(PCI_FIRST_FRAME << PCI_TYPE_OFFSET);
+		frame[1] = 0u;
+		frame[2] = (uint8_t)(size >> 24u);
+		frame[3] = (uint8_t)(size >> 16u);
+		frame[4] = (uint8_t)(size >> 8u);
+		frame[5] = (uint8_t)size;
+		headerSize = 6u;
+	}
+	const uint32_t payloadSize = frameSize - headerSize;
+	memcpy(&frame[headerSize], data, payloadSize);
+	if (!sendFrame(isoTp, session, frame, frameSize, errCode))
+		return false;
+
+	session->txData = data;
+	session->txSize = size;
+	session->txOffset = payloadSize;
+	session->txSequence = 1u;
+	session->txTime = now + isoTp->config.timeout;
+	session->txState = McanIsoTp_TxState_WaitFlowControl;
+	return true;
+}
+
+static void
+sendConsecutiveFrames(McanIsoTp *const isoTp,
+		McanIsoTp_Session *const session, const uint32_t now)
+{
+	uint8_t frame[FD_FRAME_SIZE];
+	const uint32_t maxPayloadSize = session->frameSize - 1u;
+
+	while ((session->txState == McanIsoTp_TxState_SendConsecutive)
+			&& isTimeReached(now, session->txTime)) {
+		uint32_t payloadSize = session->txSize - session->txOffset;
+		if (payloadSize > maxPayloadSize)
+			payloadSize = maxPayloadSize;
+
+		frame[0] = (uint8_t)((PCI_CONSECUTIVE_FRAME << PCI_TYPE_OFFSET)
+				| session->txSequence);
+		memcpy(&frame[1], &session->txData[session->txOffset],
+				payloadSize);
+		int errCode = 0;
+		if (!sendFrame(isoTp, session, frame, payloadSize + 1u,
+				    &errCode))
+			return; // Retried on the next McanIsoTp_process call.
+
+		session->txOffset += payloadSize;
+		session->txSequence = (session->txSequence + 1u) & SEQUENCE_MASK;
+
+		if (session->txOffset == session->txSize) {
+			finishTx(session, McanIsoTp_Result_Ok);
+			return;
+		}
+		if ((session->txBlockSize != 0u)
+				&& (--session->txBlockRemaining == 0u)) {
+			session->txState = McanIsoTp_TxState_WaitFlowControl;
+			session->txTime = now + isoTp->config.timeout;
+			return;
+		}
+		session->txTime = now + session->txStMin;
+	}
+}
+
+static void
+handleFlowControl(McanIsoTp *const isoTp, McanIsoTp_Session *const session,
+		const uint8_t *const data, const uint8_t size,
+		const uint32_t now)
+{
+	if (session->txState != McanIsoTp_TxState_WaitFlowControl)
+		return;
+	if (size < FLOW_CONTROL_SIZE) {
+		finishTx(session, McanIsoTp_Result_InvalidFrame);
+		return;
+	}
+
+	switch (data[0] & PCI_LOW_MASK) {
+	case FLOW_STATUS_CONTINUE:
+		session->txBlockSize = data[1];
+		session->txBlockRemaining = data[1];
+		session->txStMin = decodeStMin(data[2]);
+		session->txTime = now;
+		session->txState = McanIsoTp_TxState_SendConsecutive;
+		sendConsecutiveFrames(isoTp, session, now);
+		break;
+	case FLOW_STATUS_WAIT:
+		session->txTime = now + isoTp->config.timeout;
+		break;
+	case FLOW_STATUS_OVERFLOW:
+		finishTx(session, McanIsoTp_Result_Overflow);
+		break;
+	default: finishTx(session, McanIsoTp_Result_InvalidFrame); break;
+	}
+}
+
+static void
+handleSingleFrame(McanIsoTp *const isoTp, McanIsoTp_Session *const session,
+		const uint8_t *const data, const uint8_t size)
+{
+	uint32_t messageSize = data[0] & PCI_LOW_MASK;
+	uint32_t headerSize = 1u;
+	if ((messageSize == 0u) && (size > CLASSIC_FRAME_SIZE)) {
+		messageSize = data[1];
+		headerSize = 2u;
+	}
+	if ((messageSize == 0u) || (headerSize + messageSize > size))
+		return;
+
+	if (session->rxState != McanIsoTp_RxState_Idle)
+		finishRx(isoTp, session, McanIsoTp_Result_Interrupted);
+
+	session->rxSize = messageSize;
+	session->rxBuffer = (messageSize <= isoTp->config.poolBufferSize)
+			? acquireBuffer(isoTp)
+			: NULL;
+	if (session->rxBuffer == NULL) {
+		finishRx(isoTp, session, McanIsoTp_Result_Overflow);
+		return;
+	}
+	memcpy(session->rxBuffer, &data[headerSize], messageSize);
+	finishRx(isoTp, session, McanIsoTp_Result_Ok);
+}
+
+static void
+handleFirstFrame(McanIsoTp *const isoTp, McanIsoTp_Session *const session,
+		const uint8_t *const data, const uint8_t size,
+		const uint32_t now)
+{
+	if (size < CLASSIC_FRAME_SIZE)
+		return;
+
+	uint32_t messageSize = ((uint32_t)(data[0] & PCI_LOW_MASK) << 8u)
+			| data[1];
+	uint32_t headerSize = 2u;
+	if (messageSize == 0u) {
+		messageSize = ((uint32_t)data[2] << 24u)
+				| ((uint32_t)data[3] << 16u)
+				| ((uint32_t)data[4] << 8u) | data[5];
+		headerSize = 6u;
+	}
+	const uint32_t payloadSize = size - headerSize;
+	if (messageSize <= payloadSize)
+		return;
+
+	if (session->rxState != McanIsoTp_RxState_Idle)
+		finishRx(isoTp, session, McanIsoTp_Result_Interrupted);
+
+	session->rxSize = messageSize;
+	session->rxBuffer = (messageSize <= isoTp->config.poolBufferSize)
+			? acquireBuffer(isoTp)
+			: NULL;
+	if (session->rxBuffer == NULL) {
+		sendFlowControl(isoTp, session, FLOW_STATUS_OVERFLOW);
+		finishRx(isoTp, session, McanIsoTp_Result_Overflow);
+		return;
+	}
+
+	memcpy(session->rxBuffer, &data[headerSize], payloadSize);
+	session->rxOffset = payloadSize;
+	session->rxSequence = 1u;
+	session->rxBlockRemaining = session->config.blockSize;
+	session->rxTimeout = now + isoTp->config.timeout;
+	session->rxState = McanIsoTp_RxState_ReceiveConsecutive;
+	sendFlowControl(isoTp, session, FLOW_STATUS_CONTINUE);
+}
+
+static void
+handleConsecutiveFrame(McanIsoTp *const isoTp,
+		McanIsoTp_Session *const session, const uint8_t *const data,
+		const uint8_t size, const uint32_t now)
+{
+	if ((session->rxState != McanIsoTp_RxState_ReceiveConsecutive)
+			|| (size < 2u))
+		return;
+	if ((data[0] & PCI_LOW_MASK) != session->rxSequence) {
+		finishRx(isoTp, session, McanIsoTp_Result_WrongSequence);
+		return;
+	}
+
+	uint32_t payloadSize = size - 1u;
+	if (payloadSize > session->rxSize - session->rxOffset)
+		payloadSize = session->rxSize - session->rxOffset;
+	memcpy(&session->rxBuffer[session->rxOffset], &data[1], payloadSize);
+	session->rxOffset += payloadSize;
+	session->rxSequence = (session->rxSequence + 1u) & SEQUENCE_MASK;
+
+	if (session->rxOffset == session->rxSize) {
+		finishRx(isoTp, session, McanIsoTp_Result_Ok);
+		return;
+	}
+	session->rxTimeout = now + isoTp->config.timeout;
+	if ((session->config.blockSize != 0u)
+			&& (--session->rxBlockRemaining == 0u)) {
+		session->rxBlockRemaining = session->config.blockSize;
+		sendFlowControl(isoTp, session, FLOW_STATUS_CONTINUE);
+	}
+}
+
+void
+McanIsoTp_handleFrame(McanIsoTp *const isoTp,
+		McanIsoTp_Session *const session, const uint8_t *const data,
+		const uint8_t size, const uint32_t now)
+{
+	if (size == 0u)
+		return;
+
+	switch (data[0] >> PCI_TYPE_OFFSET) {
+	case PCI_SINGLE_FRAME: handleSingleFrame(isoTp, session, data, size); break;
+	case PCI_FIRST_FRAME:
+		handleFirstFrame(isoTp, session, data, size, now);
+		break;
+	case PCI_CONSECUTIVE_FRAME:
+		handleConsecutiveFrame(isoTp, session, data, size, now);
+		break;
+	case PCI_FLOW_CONTROL:
+		handleFlowControl(isoTp, session, data, size, now);
+		break;
+	default: break;
+	}
+}
+
+void
+McanIsoTp_process(McanIsoTp *const isoTp, const uint32_t now)
+{
+	for (uint32_t i = 0; i < isoTp->config.sessionCount; i++) {
+		McanIsoTp_Session *const session = &isoTp->config.sessions[i];
+		if (!session->isConfigured)
+			continue;
+
+		if (session->isFlowControlPending)
+			sendFlowControl(isoTp, session,
+					session->pendingFlowStatus);
+
+		if (session->txState == McanIsoTp_TxState_SendConsecutive)
+			sendConsecutiveFrames(isoTp, session, now);
+		else if ((session->txState
+					 == McanIsoTp_TxState_WaitFlowControl)
+				&& isTimeReached(now, session->txTime))
+			finishTx(session, McanIsoTp_Result_Timeout);
+
+		if ((session->rxState == McanIsoTp_RxState_ReceiveConsecutive)
+				&& isTimeReached(now, session->rxTimeout))
+			finishRx(isoTp, session, McanIsoTp_Result_Timeout);
+	}
+}
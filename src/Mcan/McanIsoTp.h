@@ -0,0 +1,234 @@
+/**@file
+ * This file is part of the ARM BSP for the Test Environment.
+ *
+ * @copyright 2020-2021 N7 Space Sp. z o.o.
+ *
+ * Test Environment was developed under a programme of,
+ * and funded by, the European Space Agency (the "ESA").
+ *
+ *
+ * Licensed under the ESA Public License (ESA-PL) Permissive,
+ * Version 2.3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://essr.esa.int/license/list
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @defgroup McanIsoTp McanIsoTp
+ * @ingroup Mcan
+ * @{
+ */
+
+#ifndef BSP_MCAN_ISO_TP_H
+#define BSP_MCAN_ISO_TP_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "Mcan.h"
+
+/// \brief Maximum number of reception buffers in the buffer pool.
+#define MCAN_ISO_TP_MAX_POOL_BUFFERS 32u
+
+/// \brief Default N_Bs/N_Cr timeout in [us].
+#define MCAN_ISO_TP_DEFAULT_TIMEOUT 1000000u
+
+/// \brief ISO-TP error codes.
+typedef enum {
+	/// \brief A transmission is already in progress in the session.
+	McanIsoTp_ErrorCodes_SessionBusy = 1,
+	/// \brief The message is empty or too large for the session frame format.
+	McanIsoTp_ErrorCodes_InvalidSize = 2,
+	/// \brief The session index exceeds the number of sessions.
+	McanIsoTp_ErrorCodes_InvalidSession = 3,
+} McanIsoTp_ErrorCodes;
+
+/// \brief Result of a transfer, reported by the session callbacks.
+typedef enum {
+	McanIsoTp_Result_Ok = 0, ///< Transfer completed.
+	McanIsoTp_Result_Timeout = 1, ///< Flow control or frame timeout.
+	McanIsoTp_Result_WrongSequence = 2, ///< Unexpected sequence number.
+	/// \brief The receiver reported an overflow, or no reception buffer
+	///        was available.
+	McanIsoTp_Result_Overflow = 3,
+	/// \brief The reception was interrupted by a new message.
+	McanIsoTp_Result_Interrupted = 4,
+	McanIsoTp_Result_InvalidFrame = 5, ///< Malformed frame received.
+} McanIsoTp_Result;
+
+/// \brief Session transmission states.
+typedef enum {
+	McanIsoTp_TxState_Idle = 0, ///< No transmission.
+	McanIsoTp_TxState_WaitFlowControl = 1, ///< Waiting for Flow Control.
+	McanIsoTp_TxState_SendConsecutive = 2, ///< Sending Consecutive Frames.
+} McanIsoTp_TxState;
+
+/// \brief Session reception states.
+typedef enum {
+	McanIsoTp_RxState_Idle = 0, ///< No reception.
+	/// \brief Receiving Consecutive Frames.
+	McanIsoTp_RxState_ReceiveConsecutive = 1,
+} McanIsoTp_RxState;
+
+struct McanIsoTp_Session;
+
+/// \brief A function serving as a callback called at the end of a reception.
+/// \param [in] session Session which received the message.
+/// \param [in] result Result of the reception.
+/// \param [in] data Pool buffer holding the message, NULL if the reception
+///        failed. The buffer shall be returned with McanIsoTp_releaseBuffer.
+/// \param [in] size Message size.
+/// \param [in] arg Argument from the session configuration.
+typedef void (*McanIsoTpRxCallback)(struct McanIsoTp_Session *session,
+		McanIsoTp_Result result, uint8_t *data, uint32_t size,
+		void *arg);
+
+/// \brief A function serving as a callback called at the end of a
+///        transmission, after which the message buffer can be reused.
+/// \param [in] session Session which sent the message.
+/// \param [in] result Result of the transmission.
+/// \param [in] arg Argument from the session configuration.
+typedef void (*McanIsoTpTxCallback)(struct McanIsoTp_Session *session,
+		McanIsoTp_Result result, void *arg);
+
+/// \brief Session configuration.
+typedef struct {
+	Mcan_IdType idType; ///< Type of the identifiers.
+	uint32_t txId; ///< Identifier of the sent frames.
+	uint32_t rxId; ///< Identifier of the received frames.
+	bool isCanFd; ///< Use 64-byte CAN FD frames instead of 8-byte frames.
+	bool isBitRateSwitchingEnabled; ///< Bit rate switching enable flag.
+	/// \brief Block size sent in Flow Control frames; 0 - no limit.
+	uint8_t blockSize;
+	/// \brief STmin sent in Flow Control frames, in the ISO 15765-2
+	///        encoding (0x00-0x7F [ms], 0xF1-0xF9 100-900 [us]).
+	uint8_t stMin;
+	uint8_t paddingByte; ///< Value of unused frame bytes.
+	McanIsoTpRxCallback rxCallback; ///< Reception callback.
+	McanIsoTpTxCallback txCallback; ///< Transmission callback.
+	void *arg; ///< Argument to the callbacks.
+} McanIsoTp_SessionConfig;
+
+/// \brief Session descriptor.
+typedef struct McanIsoTp_Session {
+	McanIsoTp_SessionConfig config; ///< Session configuration.
+	bool isConfigured; ///< Whether the session was configured.
+	uint8_t frameSize; ///< Data size of full frames.
+	Mcan_TxTemplate frameTemplate; ///< Template of full frames.
+
+	McanIsoTp_TxState txState; ///< Transmission state.
+	const uint8_t *txData; ///< Message being sent.
+	uint32_t txSize; ///< Size of the message being sent.
+	uint32_t txOffset; ///< Number of bytes sent.
+	uint8_t txSequence; ///< Sequence number of the next Consecutive Frame.
+	uint8_t txBlockSize; ///< Block size requested by the receiver.
+	uint8_t txBlockRemaining; ///< Frames left in the current block.
+	uint32_t txStMin; ///< Separation time requested by the receiver in [us].
+	uint32_t txTime; ///< Time of the next frame or timeout in [us].
+
+	McanIsoTp_RxState rxState; ///< Reception state.
+	uint8_t *rxBuffer; ///< Pool buffer of the message being received.
+	uint32_t rxSize; ///< Size of the message being received.
+	uint32_t rxOffset; ///< Number of bytes received.
+	uint8_t rxSequence; ///< Expected Consecutive Frame sequence number.
+	uint8_t rxBlockRemaining; ///< Frames left in the current block.
+	uint32_t rxTimeout; ///< Reception timeout time in [us].
+	/// \brief Flow Control frame which could not be queued yet.
+	bool isFlowControlPending;
+	uint8_t pendingFlowStatus; ///< Flow status of the pending frame.
+} McanIsoTp_Session;
+
+/// \brief ISO-TP configuration and storage, provided by the user.
+typedef struct {
+	Mcan *mcan; ///< Mcan device descriptor; frames are sent via the Tx Queue.
+	McanIsoTp_Session *sessions; ///< Sessions.
+	uint32_t sessionCount; ///< Number of sessions.
+	/// \brief Memory of the reception buffer pool, poolBufferCount buffers
+	///        of poolBufferSize bytes each.
+	uint8_t *poolMemory;
+	uint32_t poolBufferSize; ///< Size of a reception buffer.
+	/// \brief Number of reception buffers, at most MCAN_ISO_TP_MAX_POOL_BUFFERS.
+	uint32_t poolBufferCount;
+	uint32_t timeout; ///< N_Bs and N_Cr timeout in [us].
+} McanIsoTp_Config;
+
+/// \brief ISO-TP descriptor.
+typedef struct {
+	McanIsoTp_Config config; ///< Configuration and storage.
+	uint32_t freeBufferMask; ///< Free reception buffers.
+} McanIsoTp;
+
+/// \brief Initializes the ISO-TP layer. All sessions are left unconfigured.
+/// \param [out] isoTp ISO-TP descriptor.
+/// \param [in] config Configuration and storage.
+void McanIsoTp_init(McanIsoTp *const isoTp, const McanIsoTp_Config *const config);
+
+/// \brief Configures a session, aborting its transfers without callbacks.
+/// \param [in] isoTp ISO-TP descriptor.
+/// \param [in] index Session index.
+/// \param [in] config Session configuration.
+/// \param [out] errCode An error code generated during the operation.
+/// \retval true Configuring the session was successful.
+/// \retval false Configuring the session failed.
+bool McanIsoTp_configureSession(McanIsoTp *const isoTp, const uint32_t index,
+		const McanIsoTp_SessionConfig *const config, int *const errCode);
+
+/// \brief Returns the session receiving frames with the given identifier.
+/// \param [in] isoTp ISO-TP descriptor.
+/// \param [in] idType Type of the identifier.
+/// \param [in] id Identifier.
+/// \returns Session, or NULL if none matches.
+McanIsoTp_Session *McanIsoTp_findSession(const McanIsoTp *const isoTp,
+		const Mcan_IdType idType, const uint32_t id);
+
+/// \brief Starts sending a message. The message is read directly from the
+///        given buffer, which shall stay valid until the transmission callback.
+///        Messages fitting in a Single Frame complete within this call.
+/// \param [in] isoTp ISO-TP descriptor.
+/// \param [in] session Session descriptor.
+/// \param [in] data Message.
+/// \param [in] size Message size.
+/// \param [in] now Current time in [us].
+/// \param [out] errCode An error code generated during the operation.
+/// \retval true Transmission was started.
+/// \retval false Transmission could not be started.
+bool McanIsoTp_send(McanIsoTp *const isoTp, McanIsoTp_Session *const session,
+		const uint8_t *const data, const uint32_t size,
+		const uint32_t now, int *const errCode);
+
+/// \brief Handles a frame received by a session; the payload is copied
+///        directly into the reception buffer, so it can be passed straight
+///        from the message RAM, e.g. using Mcan_rxViewGetData.
+/// \param [in] isoTp ISO-TP descriptor.
+/// \param [in] session Session which received the frame.
+/// \param [in] data Frame data.
+/// \param [in] size Frame data size.
+/// \param [in] now Current time in [us].
+void McanIsoTp_handleFrame(McanIsoTp *const isoTp,
+		McanIsoTp_Session *const session, const uint8_t *const data,
+		const uint8_t size, const uint32_t now);
+
+/// \brief Sends pending Consecutive and Flow Control frames while the Tx
+///        Queue has room and checks the timeouts of all sessions. Shall be
+///        called periodically, e.g. on a timer or the Tx FIFO Empty interrupt,
+///        and shall not preempt nor be preempted by McanIsoTp_handleFrame.
+/// \param [in] isoTp ISO-TP descriptor.
+/// \param [in] now Current time in [us].
+void McanIsoTp_process(McanIsoTp *const isoTp, const uint32_t now);
+
+/// \brief Returns a reception buffer to the pool.
+/// \param [in] isoTp ISO-TP descriptor.
+/// \param [in] buffer Buffer passed to the reception callback.
+void McanIsoTp_releaseBuffer(McanIsoTp *const isoTp, uint8_t *const buffer);
+
+#endif // BSP_MCAN_ISO_TP_H
+
+/** @} */
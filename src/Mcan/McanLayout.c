@@ -0,0 +1,289 @@
+/**@file
+ * This file is part of the ARM BSP for the Test Environment.
+ *
+ * @copyright 2020-2021 N7 Space Sp. z o.o.
+ *
+ * Test Environment was developed under a programme of,
+ * and funded by, the European Space Agency (the "ESA").
+ *
+ *
+ * Licensed under the ESA Public License (ESA-PL) Permissive,
+ * Version 2.3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://essr.esa.int/license/list
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "McanLayout.h"
+
+#include <assert.h>
+#include <stddef.h>
+
+#include <Utils/Utils.h>
+
+#define WINDOW_MASK (~(MCAN_LAYOUT_WINDOW_SIZE - 1u))
+
+/// \brief Message RAM section extent.
+typedef struct {
+	uint32_t address; ///< Section start address.
+	uint32_t size; ///< Section size in bytes.
+} Section;
+
+enum { MaxSections = 7 };
+
+static uint32_t
+elementSizeInBytes(const Mcan_ElementSize size)
+{
+	static const uint8_t dataSizes[] = { 8, 12, 16, 20, 24, 32, 48, 64 };
+	assert((uint32_t)size < (sizeof(dataSizes) / sizeof(dataSizes[0])));
+	return dataSizes[size] + MCAN_LAYOUT_ELEMENT_HEADER_SIZE;
+}
+
+static bool
+areRequirementsWithinLimits(const McanLayout_Requirements *const requirements)
+{
+	return (requirements->standardFilterCount
+			       <= MCAN_LAYOUT_MAX_STANDARD_FILTERS)
+			&& (requirements->extendedFilterCount
+					<= MCAN_LAYOUT_MAX_EXTENDED_FILTERS)
+			&& (requirements->rxFifo0Count
+					<= MCAN_LAYOUT_MAX_RX_FIFO_ELEMENTS)
+			&& (requirements->rxFifo1Count
+					<= MCAN_LAYOUT_MAX_RX_FIFO_ELEMENTS)
+			&& (requirements->rxBufferCount
+					<= MCAN_LAYOUT_MAX_RX_BUFFER_ELEMENTS)
+			&& (requirements->txEventFifoCount
+					<= MCAN_LAYOUT_MAX_TX_EVENT_ELEMENTS)
+			&& (((uint32_t)requirements->txBufferCount
+					    + requirements->txQueueCount)
+					<= MCAN_LAYOUT_MAX_TX_ELEMENTS);
+}
+
+static uint32_t *
+allocate(uint32_t **const next, const uint32_t count, const uint32_t size)
+{
+	if (count == 0u)
+		return NULL;
+	uint32_t *const address = *next;
+	*next += (count * size) / sizeof(uint32_t);
+	return address;
+}
+
+bool
+McanLayout_plan(const McanLayout_Requirements *const requirements,
+		uint32_t *const ramAddress, const uint32_t ramSize,
+		Mcan_Config *const config, uint32_t *const usedSize,
+		int *const errCode)
+{
+	assert(requirements != NULL);
+	assert(config != NULL);
+
+	if (!areRequirementsWithinLimits(requirements))
+		return returnError(errCode,
+				McanLayout_ErrorCodes_TooManyElements);
+	if (((uint32_t)ramAddress % sizeof(uint32_t)) != 0u)
+		return returnError(errCode,
+				McanLayout_ErrorCodes_MisalignedSection);
+
+	const uint32_t rxFifo0ElementSize =
+			elementSizeInBytes(requirements->rxFifo0ElementSize);
+	const uint32_t rxFifo1ElementSize =
+			elementSizeInBytes(requirements->rxFifo1ElementSize);
+	const uint32_t rxBufferElementSize =
+			elementSizeInBytes(requirements->rxBufferElementSize);
+	const uint32_t txElementSize =
+			elementSizeInBytes(requirements->txElementSize);
+	const uint32_t txCount = (uint32_t)requirements->txBufferCount
+			+ requirements->txQueueCount;
+
+	// All element sizes are multiples of a word, so packing the sections
+	// back to back keeps them aligned without padding.
+	const uint32_t size = (requirements->standardFilterCount
+					      * MCAN_LAYOUT_STANDARD_FILTER_SIZE)
+			+ (requirements->extendedFilterCount
+					* MCAN_LAYOUT_EXTENDED_FILTER_SIZE)
+			+ (requirements->rxFifo0Count * rxFifo0ElementSize)
+			+ (requirements->rxFifo1Count * rxFifo1ElementSize)
+			+ (requirements->rxBufferCount * rxBufferElementSize)
+			+ (requirements->txEventFifoCount
+					* MCAN_LAYOUT_TX_EVENT_SIZE)
+			+ (txCount * txElementSize);
+	const uint32_t windowOffset =
+			(uint32_t)ramAddress & ~WINDOW_MASK;
+	if ((size > ramSize)
+			|| ((windowOffset + size) > MCAN_LAYOUT_WINDOW_SIZE))
+		return returnError(errCode,
+				McanLayout_ErrorCodes_OutOfMessageRam);
+
+	uint32_t *next = ramAddress;
+	config->msgRamBaseAddress = ramAddress;
+
+	config->standardIdFilter.filterListAddress = allocate(&next,
+			requirements->standardFilterCount,
+			MCAN_LAYOUT_STANDARD_FILTER_SIZE);
+	config->standardIdFilter.filterListSize =
+			requirements->standardFilterCount;
+	config->extendedIdFilter.filterListAddress = allocate(&next,
+			requirements->extendedFilterCount,
+			MCAN_LAYOUT_EXTENDED_FILTER_SIZE);
+	config->extendedIdFilter.filterListSize =
+			requirements->extendedFilterCount;
+
+	config->rxFifo0.isEnabled = requirements->rxFifo0Count != 0u;
+	config->rxFifo0.startAddress = allocate(
+			&next, requirements->rxFifo0Count, rxFifo0ElementSize);
+	config->rxFifo0.size = requirements->rxFifo0Count;
+	config->rxFifo0.elementSize = requirements->rxFifo0ElementSize;
+
+	config->rxFifo1.isEnabled = requirements->rxFifo1Count != 0u;
+	config->rxFifo1.startAddress = allocate(
+			&next, requirements->rxFifo1Count, rxFifo1ElementSize);
+	config->rxFifo1.size = requirements->rxFifo1Count;
+	config->rxFifo1.elementSize = requirements->rxFifo1ElementSize;
+
+	config->rxBuffer.startAddress = allocate(&next,
+			requirements->rxBufferCount, rxBufferElementSize);
+	config->rxBuffer.elementSize = requirements->rxBufferElementSize;
+
+	config->txEventFifo.isEnabled = requirements->txEventFifoCount != 0u;
+	config->txEventFifo.startAddress = allocate(&next,
+			requirements->txEventFifoCount,
+			MCAN_LAYOUT_TX_EVENT_SIZE);
+	config->txEventFifo.size = requirements->txEventFifoCount;
+
+	config->txBuffer.isEnabled = txCount != 0u;
+	config->txBuffer.startAddress =
+			allocate(&next, txCount, txElementSize);
+	config->txBuffer.bufferSize = requirements->txBufferCount;
+	config->txBuffer.queueSize = requirements->txQueueCount;
+	config->txBuffer.elementSize = requirements->txElementSize;
+
+	if (usedSize != NULL)
+		*usedSize = size;
+	return true;
+}
+
+static uint32_t
+addSection(Section *const sections, uint32_t count,
+		const uint32_t *const address, const uint32_t size)
+{
+	if (size == 0u)
+		return count;
+	sections[count].address = (uint32_t)address;
+	sections[count].size = size;
+	return count + 1u;
+}
+
+static uint32_t
+collectSections(const Mcan_Config *const config, const uint8_t rxBufferCount,
+		Section *const sections)
+{
+	uint32_t count = 0;
+	if (!config->standardIdFilter.isIdRejected)
+		count = addSection(sections, count,
+				config->standardIdFilter.filterListAddress,
+				config->standardIdFilter.filterListSize
+						* MCAN_LAYOUT_STANDARD_FILTER_SIZE);
+	if (!config->extendedIdFilter.isIdRejected)
+		count = addSection(sections, count,
+				config->extendedIdFilter.filterListAddress,
+				config->extendedIdFilter.filterListSize
+						* MCAN_LAYOUT_EXTENDED_FILTER_SIZE);
+	if (config->rxFifo0.isEnabled)
+		count = addSection(sections, count,
+				config->rxFifo0.startAddress,
+				config->rxFifo0.size
+						* elementSizeInBytes(
+								config->rxFifo0.elementSize));
+	if (config->rxFifo1.isEnabled)
+		count = addSection(sections, count,
+				config->rxFifo1.startAddress,
+				config->rxFifo1.size
+						* elementSizeInBytes(
+								config->rxFifo1.elementSize));
+	count = addSection(sections, count, config->rxBuffer.startAddress,
+			rxBufferCount
+					* elementSizeInBytes(
+							config->rxBuffer.elementSize));
+	if (config->txEventFifo.isEnabled)
+		count = addSection(sections, count,
+				config->txEventFifo.startAddress,
+				config->txEventFifo.size
+						* MCAN_LAYOUT_TX_EVENT_SIZE);
+	if (config->txBuffer.isEnabled)
+		count = addSection(sections, count,
+				config->txBuffer.startAddress,
+				((uint32_t)config->txBuffer.bufferSize
+						+ config->txBuffer.queueSize)
+						* elementSizeInBytes(
+								config->txBuffer.elementSize));
+	return count;
+}
+
+static bool
+areCountsWithinLimits(const Mcan_Config *const config,
+		const uint8_t rxBufferCount)
+{
+	return (config->standardIdFilter.filterListSize
+			       <= MCAN_LAYOUT_MAX_STANDARD_FILTERS)
+			&& (config->extendedIdFilter.filterListSize
+					<= MCAN_LAYOUT_MAX_EXTENDED_FILTERS)
+			&& (config->rxFifo0.size
+					<= MCAN_LAYOUT_MAX_RX_FIFO_ELEMENTS)
+			&& (config->rxFifo1.size
+					<= MCAN_LAYOUT_MAX_RX_FIFO_ELEMENTS)
+			&& (rxBufferCount <= MCAN_LAYOUT_MAX_RX_BUFFER_ELEMENTS)
+			&& (config->txEventFifo.size
+					<= MCAN_LAYOUT_MAX_TX_EVENT_ELEMENTS)
+			&& (((uint32_t)config->txBuffer.bufferSize
+					    + config->txBuffer.queueSize)
+					<= MCAN_LAYOUT_MAX_TX_ELEMENTS);
+}
+
+bool
+McanLayout_validate(const Mcan_Config *const config,
+		const uint8_t rxBufferCount, int *const errCode)
+{
+	assert(config != NULL);
+
+	if (!areCountsWithinLimits(config, rxBufferCount))
+		return returnError(errCode,
+				McanLayout_ErrorCodes_TooManyElements);
+
+	Section sections[MaxSections];
+	const uint32_t count =
+			collectSections(config, rxBufferCount, sections);
+	const uint32_t window = (uint32_t)config->msgRamBaseAddress
+			& WINDOW_MASK;
+
+	for (uint32_t i = 0; i < count; i++) {
+		const Section *const section = &sections[i];
+		if ((section->address % sizeof(uint32_t)) != 0u)
+			return returnError(errCode,
+					McanLayout_ErrorCodes_MisalignedSection);
+		if (((section->address & WINDOW_MASK) != window)
+				|| ((section->address & ~WINDOW_MASK)
+							   + section->size
+						> MCAN_LAYOUT_WINDOW_SIZE))
+			return returnError(errCode,
+					McanLayout_ErrorCodes_OutOfMessageRam);
+		for (uint32_t j = 0; j < i; j++) {
+			const Section *const other = &sections[j];
+			if ((section->address < (other->address + other->size))
+					&& (other->address
+							< (section->address
+									+ section->size)))
+				return returnError(errCode,
+						McanLayout_ErrorCodes_OverlappingSections);
+		}
+	}
+
+	return true;
+}
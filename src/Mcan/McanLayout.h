@@ -0,0 +1,180 @@
+/**@file
+ * This file is part of the ARM BSP for the Test Environment.
+ *
+ * @copyright 2020-2021 N7 Space Sp. z o.o.
+ *
+ * Test Environment was developed under a programme of,
+ * and funded by, the European Space Agency (the "ESA").
+ *
+ *
+ * Licensed under the ESA Public License (ESA-PL) Permissive,
+ * Version 2.3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://essr.esa.int/license/list
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @defgroup McanLayout McanLayout
+ * @ingroup Mcan
+ * @{
+ */
+
+#ifndef BSP_MCAN_LAYOUT_H
+#define BSP_MCAN_LAYOUT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "Mcan.h"
+
+/// \brief Size of the message RAM window addressable by a single MCAN
+///        instance; all sections shall share the upper 16 bits of address.
+#define MCAN_LAYOUT_WINDOW_SIZE 0x10000u
+
+#define MCAN_LAYOUT_MAX_STANDARD_FILTERS 128u ///< Standard ID filters limit.
+#define MCAN_LAYOUT_MAX_EXTENDED_FILTERS 64u ///< Extended ID filters limit.
+#define MCAN_LAYOUT_MAX_RX_FIFO_ELEMENTS 64u ///< Rx FIFO elements limit.
+#define MCAN_LAYOUT_MAX_RX_BUFFER_ELEMENTS 64u ///< Rx Buffer elements limit.
+#define MCAN_LAYOUT_MAX_TX_EVENT_ELEMENTS 32u ///< Tx Event FIFO elements limit.
+/// \brief Limit of Tx Buffer and Tx FIFO/Queue elements in total.
+#define MCAN_LAYOUT_MAX_TX_ELEMENTS 32u
+
+#define MCAN_LAYOUT_STANDARD_FILTER_SIZE 4u ///< Standard ID filter size in bytes.
+#define MCAN_LAYOUT_EXTENDED_FILTER_SIZE 8u ///< Extended ID filter size in bytes.
+#define MCAN_LAYOUT_TX_EVENT_SIZE 8u ///< Tx Event element size in bytes.
+/// \brief Size of the Rx/Tx element header preceding the data field in bytes.
+#define MCAN_LAYOUT_ELEMENT_HEADER_SIZE 8u
+
+/// \brief Evaluates to true if dataSize (in bytes) is a valid Rx/Tx element
+///        data field size.
+#define MCAN_LAYOUT_IS_DATA_SIZE_VALID(dataSize)                               \
+	((((dataSize) >= 8u) && ((dataSize) <= 24u)                            \
+			 && (((dataSize) % 4u) == 0u))                         \
+			|| ((dataSize) == 32u) || ((dataSize) == 48u)          \
+			|| ((dataSize) == 64u))
+
+/// \brief Evaluates to the message RAM size in bytes required by a layout.
+///        Data sizes are given in bytes.
+#define MCAN_LAYOUT_SIZE(standardFilters, extendedFilters, rxFifo0Count,      \
+		rxFifo0DataSize, rxFifo1Count, rxFifo1DataSize, rxBufferCount, \
+		rxBufferDataSize, txEventCount, txCount, txDataSize)           \
+	(((standardFilters)*MCAN_LAYOUT_STANDARD_FILTER_SIZE)                  \
+			+ ((extendedFilters)*MCAN_LAYOUT_EXTENDED_FILTER_SIZE) \
+			+ ((rxFifo0Count)                                      \
+					* ((rxFifo0DataSize)                   \
+							+ MCAN_LAYOUT_ELEMENT_HEADER_SIZE)) \
+			+ ((rxFifo1Count)                                      \
+					* ((rxFifo1DataSize)                   \
+							+ MCAN_LAYOUT_ELEMENT_HEADER_SIZE)) \
+			+ ((rxBufferCount)                                     \
+					* ((rxBufferDataSize)                  \
+							+ MCAN_LAYOUT_ELEMENT_HEADER_SIZE)) \
+			+ ((txEventCount)*MCAN_LAYOUT_TX_EVENT_SIZE)           \
+			+ ((txCount)                                           \
+					* ((txDataSize)                        \
+							+ MCAN_LAYOUT_ELEMENT_HEADER_SIZE)))
+
+/// \brief Evaluates to true if a layout respects the element count limits,
+///        uses valid data sizes and fits in ramSize bytes of message RAM.
+///        Arguments are the same as for MCAN_LAYOUT_SIZE, with txCount being
+///        the total of Tx Buffer and Tx FIFO/Queue elements. Intended for
+///        compile-time checks of static layouts:
+/// \code
+/// _Static_assert(MCAN_LAYOUT_IS_VALID(8, 0, 16, 8, 0, 8, 0, 8, 8, 8, 8,
+///                        sizeof(mcanMsgRam)), "Invalid MCAN layout");
+/// \endcode
+#define MCAN_LAYOUT_IS_VALID(standardFilters, extendedFilters, rxFifo0Count,  \
+		rxFifo0DataSize, rxFifo1Count, rxFifo1DataSize, rxBufferCount, \
+		rxBufferDataSize, txEventCount, txCount, txDataSize, ramSize)  \
+	(((standardFilters) <= MCAN_LAYOUT_MAX_STANDARD_FILTERS)               \
+			&& ((extendedFilters)                                  \
+					<= MCAN_LAYOUT_MAX_EXTENDED_FILTERS)   \
+			&& ((rxFifo0Count) <= MCAN_LAYOUT_MAX_RX_FIFO_ELEMENTS) \
+			&& ((rxFifo1Count) <= MCAN_LAYOUT_MAX_RX_FIFO_ELEMENTS) \
+			&& ((rxBufferCount)                                    \
+					<= MCAN_LAYOUT_MAX_RX_BUFFER_ELEMENTS) \
+			&& ((txEventCount)                                     \
+					<= MCAN_LAYOUT_MAX_TX_EVENT_ELEMENTS)  \
+			&& ((txCount) <= MCAN_LAYOUT_MAX_TX_ELEMENTS)          \
+			&& MCAN_LAYOUT_IS_DATA_SIZE_VALID(rxFifo0DataSize)     \
+			&& MCAN_LAYOUT_IS_DATA_SIZE_VALID(rxFifo1DataSize)     \
+			&& MCAN_LAYOUT_IS_DATA_SIZE_VALID(rxBufferDataSize)    \
+			&& MCAN_LAYOUT_IS_DATA_SIZE_VALID(txDataSize)          \
+			&& ((ramSize) <= MCAN_LAYOUT_WINDOW_SIZE)              \
+			&& (MCAN_LAYOUT_SIZE(standardFilters, extendedFilters, \
+					    rxFifo0Count, rxFifo0DataSize,     \
+					    rxFifo1Count, rxFifo1DataSize,     \
+					    rxBufferCount, rxBufferDataSize,   \
+					    txEventCount, txCount, txDataSize) \
+					<= (ramSize)))
+
+/// \brief Message RAM layout planner error codes.
+typedef enum {
+	/// \brief A section exceeds its element count limit.
+	McanLayout_ErrorCodes_TooManyElements = 1,
+	/// \brief A section is not aligned to a 32-bit word.
+	McanLayout_ErrorCodes_MisalignedSection = 2,
+	/// \brief Sections do not fit in the message RAM or cross the 64 kB
+	///        window of the message RAM base address.
+	McanLayout_ErrorCodes_OutOfMessageRam = 3,
+	/// \brief Two sections overlap.
+	McanLayout_ErrorCodes_OverlappingSections = 4,
+} McanLayout_ErrorCodes;
+
+/// \brief Element counts and sizes of the message RAM sections. Sections with
+///        no elements are disabled.
+typedef struct {
+	uint8_t standardFilterCount; ///< Number of standard ID filters.
+	uint8_t extendedFilterCount; ///< Number of extended ID filters.
+	uint8_t rxFifo0Count; ///< Number of Rx FIFO 0 elements.
+	Mcan_ElementSize rxFifo0ElementSize; ///< Rx FIFO 0 element size.
+	uint8_t rxFifo1Count; ///< Number of Rx FIFO 1 elements.
+	Mcan_ElementSize rxFifo1ElementSize; ///< Rx FIFO 1 element size.
+	uint8_t rxBufferCount; ///< Number of dedicated Rx Buffer elements.
+	Mcan_ElementSize rxBufferElementSize; ///< Rx Buffer element size.
+	uint8_t txEventFifoCount; ///< Number of Tx Event FIFO elements.
+	uint8_t txBufferCount; ///< Number of dedicated Tx Buffer elements.
+	uint8_t txQueueCount; ///< Number of Tx FIFO/Queue elements.
+	Mcan_ElementSize txElementSize; ///< Tx element size.
+} McanLayout_Requirements;
+
+/// \brief Places the message RAM sections back to back in the given memory
+///        area and stores their addresses and sizes in the configuration.
+///        Other settings of the configuration (watermarks, modes, filtering
+///        policies) are left unchanged.
+/// \param [in] requirements Element counts and sizes of the sections.
+/// \param [in] ramAddress Address of the memory area for the message RAM.
+/// \param [in] ramSize Size of the memory area in bytes.
+/// \param [in,out] config Mcan configuration to update.
+/// \param [out] usedSize Number of bytes occupied by the sections.
+/// \param [out] errCode An error code generated during the operation.
+/// \retval true Planning was successful.
+/// \retval false Requirements cannot be satisfied within the memory area.
+bool McanLayout_plan(const McanLayout_Requirements *const requirements,
+		uint32_t *const ramAddress, const uint32_t ramSize,
+		Mcan_Config *const config, uint32_t *const usedSize,
+		int *const errCode);
+
+/// \brief Checks the message RAM sections of a configuration against the
+///        element count limits, the 64 kB window of the message RAM base
+///        address and each other.
+/// \param [in] config Mcan configuration.
+/// \param [in] rxBufferCount Number of dedicated Rx Buffer elements in use,
+///        as the configuration does not define it.
+/// \param [out] errCode An error code generated during the operation.
+/// \retval true Layout is valid.
+/// \retval false Layout is invalid.
+bool McanLayout_validate(const Mcan_Config *const config,
+		const uint8_t rxBufferCount, int *const errCode);
+
+#endif // BSP_MCAN_LAYOUT_H
+
+/** @} */
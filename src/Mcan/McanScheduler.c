@@ -0,0 +1,312 @@
+/**@file
+ * This file is part of the ARM BSP for the Test Environment.
+ *
+ * @copyright 2020-2021 N7 Space Sp. z o.o.
+ *
+ * Test Environment was developed under a programme of,
+ * and funded by, the European Space Agency (the "ESA").
+ *
+ *
+ * Licensed under the ESA Public License (ESA-PL) Permissive,
+ * Version 2.3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://essr.esa.int/license/list
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "McanScheduler.h"
+
+#include <assert.h>
+#include <stddef.h>
+#include <string.h>
+
+#include <Utils/Utils.h>
+
+#define EXTENDED_ID_LOW_BITS 18u
+#define EXTENDED_ID_LOW_MASK 0x3FFFFu
+#define KEY_BASE_ID_OFFSET 20u
+#define KEY_IDE_OFFSET 19u
+#define KEY_EXTENDED_ID_OFFSET 1u
+
+/// \brief Disables interrupts, returning the previous PRIMASK value.
+static inline uint32_t
+lock(void)
+{
+	uint32_t primask;
+	asm volatile("mrs %0, primask\n"
+		     "cpsid i\n"
+			: "=r"(primask)
+			:
+			: "memory");
+	return primask;
+}
+
+/// \brief Restores PRIMASK saved by lock.
+static inline void
+unlock(const uint32_t primask)
+{
+	asm volatile("msr primask, %0\n" : : "r"(primask) : "memory");
+}
+
+/// \brief Computes a key ordered as frames are in arbitration: by the base
+///        identifier, then standard before extended frames, then by the
+///        identifier extension and finally data before remote frames.
+static uint32_t
+getKey(const Mcan_TxElement *const element)
+{
+	const uint32_t remote = element->frameType == Mcan_FrameType_Remote
+			? 1u
+			: 0u;
+	if (element->idType == Mcan_IdType_Standard)
+		return (element->id << KEY_BASE_ID_OFFSET) | remote;
+	return ((element->id >> EXTENDED_ID_LOW_BITS) << KEY_BASE_ID_OFFSET)
+			| (1u << KEY_IDE_OFFSET)
+			| ((element->id & EXTENDED_ID_LOW_MASK)
+					<< KEY_EXTENDED_ID_OFFSET)
+			| remote;
+}
+
+static bool
+isBefore(const McanScheduler *const scheduler, const uint16_t first,
+		const uint16_t second)
+{
+	const McanScheduler_Entry *const a = &scheduler->config.entries[first];
+	const McanScheduler_Entry *const b = &scheduler->config.entries[second];
+	if (a->key != b->key)
+		return a->key < b->key;
+	return (int32_t)(a->sequence - b->sequence) < 0;
+}
+
+static void
+heapPush(McanScheduler *const scheduler, const uint16_t entry)
+{
+	uint16_t *const heap = scheduler->config.heap;
+	uint32_t position = scheduler->heapSize++;
+	while (position > 0u) {
+		const uint32_t parent = (position - 1u) / 2u;
+		if (!isBefore(scheduler, entry, heap[parent]))
+			break;
+		heap[position] = heap[parent];
+		position = parent;
+	}
+	heap[position] = entry;
+}
+
+static uint16_t
+heapPop(McanScheduler *const scheduler)
+{
+	uint16_t *const heap = scheduler->config.heap;
+	const uint16_t top = heap[0];
+	const uint16_t last = heap[--scheduler->heapSize];
+	const uint32_t size = scheduler->heapSize;
+	uint32_t position = 0;
+	for (;;) {
+		uint32_t child = (2u * position) + 1u;
+		if (child >= size)
+			break;
+		if ((child + 1u < size)
+				&& isBefore(scheduler, heap[child + 1u], heap[child]))
+			child++;
+		if (!isBefore(scheduler, heap[child], last))
+			break;
+		heap[position] = heap[child];
+		position = child;
+	}
+	if (size != 0u)
+		heap[position] = last;
+	return top;
+}
+
+static void
+freeEntry(McanScheduler *const scheduler, const uint16_t entry)
+{
+	scheduler->config.entries[entry].next = scheduler->freeEntry;
+	scheduler->freeEntry = entry;
+}
+
+void
+McanScheduler_init(McanScheduler *const scheduler,
+		const McanScheduler_Config *const config)
+{
+	assert(config->bufferCount <= MCAN_SCHEDULER_MAX_BUFFERS);
+	assert((uint32_t)config->firstBuffer + config->bufferCount
+			<= MCAN_SCHEDULER_MAX_BUFFERS);
+
+	memset(scheduler, 0, sizeof(McanScheduler));
+	scheduler->config = *config;
+	scheduler->freeEntry = MCAN_SCHEDULER_NO_ENTRY;
+	for (uint32_t i = config->entryCount; i > 0u; i--) {
+		const uint16_t entry = (uint16_t)(i - 1u);
+		config->entries[entry].data = &config->dataMemory[(uint32_t)entry
+				* config->maxDataSize];
+		freeEntry(scheduler, entry);
+	}
+	for (uint32_t i = 0; i < MCAN_SCHEDULER_MAX_BUFFERS; i++)
+		scheduler->slots[i] = MCAN_SCHEDULER_NO_ENTRY;
+
+	const uint32_t mask = (config->bufferCount == MCAN_SCHEDULER_MAX_BUFFERS)
+			? UINT32_MAX
+			: (1u << config->bufferCount) - 1u;
+	scheduler->bufferMask = mask << config->firstBuffer;
+	config->mcan->reg->txbcie |= scheduler->bufferMask;
+}
+
+static void
+reclaimBuffers(McanScheduler *const scheduler)
+{
+	const Mcan *const mcan = scheduler->config.mcan;
+	uint32_t doneMask = scheduler->busyMask & ~mcan->reg->txbrp;
+	if (doneMask == 0u)
+		return;
+
+	const uint32_t returnedMask =
+			doneMask & scheduler->cancelMask & ~mcan->reg->txbto;
+	scheduler->busyMask &= ~doneMask;
+	scheduler->cancelMask &= ~doneMask;
+	while (doneMask != 0u) {
+		const uint32_t index = (uint32_t)__builtin_ctz(doneMask);
+		const uint32_t mask = 1u << index;
+		doneMask &= ~mask;
+		const uint16_t entry = scheduler->slots[index];
+		scheduler->slots[index] = MCAN_SCHEDULER_NO_ENTRY;
+		if ((returnedMask & mask) != 0u) {
+			heapPush(scheduler, entry);
+			scheduler->cancelCount++;
+		} else {
+			freeEntry(scheduler, entry);
+		}
+	}
+}
+
+/// \brief Checks whether a frame with the given key is pending in a Tx
+///        Buffer. Such frames would be sent in the order of buffer indexes
+///        instead of the order of submission.
+static bool
+isKeyPending(const McanScheduler *const scheduler, const uint32_t key)
+{
+	uint32_t busyMask = scheduler->busyMask;
+	while (busyMask != 0u) {
+		const uint32_t index = (uint32_t)__builtin_ctz(busyMask);
+		busyMask &= busyMask - 1u;
+		if (scheduler->config.entries[scheduler->slots[index]].key == key)
+			return true;
+	}
+	return false;
+}
+
+static void
+refillBuffers(McanScheduler *const scheduler)
+{
+	uint32_t freeMask = scheduler->bufferMask & ~scheduler->busyMask;
+	while ((freeMask != 0u) && (scheduler->heapSize != 0u)) {
+		const McanScheduler_Entry *const top =
+				&scheduler->config.entries[scheduler->config.heap[0]];
+		if (isKeyPending(scheduler, top->key))
+			return;
+
+		const uint16_t entry = heapPop(scheduler);
+		const uint8_t index = (uint8_t)__builtin_ctz(freeMask);
+		const uint32_t mask = 1u << index;
+		int errCode = 0;
+		(void)Mcan_txBufferAddTemplate(scheduler->config.mcan,
+				&scheduler->config.entries[entry].tmpl,
+				scheduler->config.entries[entry].data, index,
+				&errCode);
+		scheduler->slots[index] = entry;
+		scheduler->busyMask |= mask;
+		freeMask &= ~mask;
+	}
+}
+
+static void
+cancelLowerPriority(McanScheduler *const scheduler)
+{
+	if ((scheduler->heapSize == 0u) || (scheduler->cancelMask != 0u)
+			|| (scheduler->busyMask != scheduler->bufferMask))
+		return;
+
+	uint32_t busyMask = scheduler->busyMask;
+	uint32_t worstIndex = (uint32_t)__builtin_ctz(busyMask);
+	busyMask &= busyMask - 1u;
+	while (busyMask != 0u) {
+		const uint32_t index = (uint32_t)__builtin_ctz(busyMask);
+		busyMask &= busyMask - 1u;
+		if (isBefore(scheduler, scheduler->slots[worstIndex],
+				    scheduler->slots[index]))
+			worstIndex = index;
+	}
+
+	const uint16_t worst = scheduler->slots[worstIndex];
+	const uint16_t top = scheduler->config.heap[0];
+	if (scheduler->config.entries[top].key
+			< scheduler->config.entries[worst].key) {
+		scheduler->cancelMask = 1u << worstIndex;
+		scheduler->config.mcan->reg->txbcr = scheduler->cancelMask;
+	}
+}
+
+static void
+process(McanScheduler *const scheduler)
+{
+	reclaimBuffers(scheduler);
+	refillBuffers(scheduler);
+	if (scheduler->config.isCancellationEnabled)
+		cancelLowerPriority(scheduler);
+}
+
+bool
+McanScheduler_submit(McanScheduler *const scheduler,
+		const Mcan_TxElement *const element, int *const errCode)
+{
+	if (element->dataSize > scheduler->config.maxDataSize)
+		return returnError(errCode, McanScheduler_ErrorCodes_DataTooLarge);
+
+	const uint32_t primask = lock();
+	const uint16_t entry = scheduler->freeEntry;
+	if (entry == MCAN_SCHEDULER_NO_ENTRY) {
+		unlock(primask);
+		return returnError(errCode, McanScheduler_ErrorCodes_QueueFull);
+	}
+	McanScheduler_Entry *const storage = &scheduler->config.entries[entry];
+	scheduler->freeEntry = storage->next;
+
+	storage->key = getKey(element);
+	storage->sequence = scheduler->sequence++;
+	Mcan_txTemplatePrepare(element, &storage->tmpl);
+	storage->tmpl.isInterruptEnabled = true;
+	memcpy(storage->data, element->data, element->dataSize);
+
+	heapPush(scheduler, entry);
+	process(scheduler);
+	unlock(primask);
+	return true;
+}
+
+void
+McanScheduler_process(McanScheduler *const scheduler)
+{
+	const uint32_t primask = lock();
+	process(scheduler);
+	unlock(primask);
+}
+
+void
+McanScheduler_handleInterrupt(uint32_t flags, void *arg)
+{
+	(void)flags;
+	McanScheduler_process((McanScheduler *)arg);
+}
+
+uint32_t
+McanScheduler_getPendingCount(const McanScheduler *const scheduler)
+{
+	return scheduler->heapSize
+			+ (uint32_t)__builtin_popcount(scheduler->busyMask);
+}
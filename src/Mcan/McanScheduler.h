@@ -0,0 +1,136 @@
+/**@file
+ * This file is part of the ARM BSP for the Test Environment.
+ *
+ * @copyright 2020-2021 N7 Space Sp. z o.o.
+ *
+ * Test Environment was developed under a programme of,
+ * and funded by, the European Space Agency (the "ESA").
+ *
+ *
+ * Licensed under the ESA Public License (ESA-PL) Permissive,
+ * Version 2.3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://essr.esa.int/license/list
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @defgroup McanScheduler McanScheduler
+ * @ingroup Mcan
+ * @{
+ */
+
+#ifndef BSP_MCAN_SCHEDULER_H
+#define BSP_MCAN_SCHEDULER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "Mcan.h"
+
+/// \brief Value of an unused entry index.
+#define MCAN_SCHEDULER_NO_ENTRY UINT16_MAX
+
+/// \brief Maximum number of Tx Buffers owned by the scheduler.
+#define MCAN_SCHEDULER_MAX_BUFFERS 32u
+
+/// \brief Scheduler error codes.
+typedef enum {
+	/// \brief All scheduler entries are occupied by pending frames.
+	McanScheduler_ErrorCodes_QueueFull = 1,
+	/// \brief Frame data exceeds the configured maximum data size.
+	McanScheduler_ErrorCodes_DataTooLarge = 2,
+} McanScheduler_ErrorCodes;
+
+/// \brief Pending frame storage.
+typedef struct {
+	uint32_t key; ///< Arbitration priority; lower values win arbitration.
+	uint32_t sequence; ///< Submission order of frames with equal keys.
+	Mcan_TxTemplate tmpl; ///< Encoded frame header.
+	uint8_t *data; ///< Frame data, within the configured data memory.
+	uint16_t next; ///< Next free entry, while the entry is free.
+} McanScheduler_Entry;
+
+/// \brief Scheduler configuration and storage, provided by the user.
+typedef struct {
+	Mcan *mcan; ///< Mcan device descriptor.
+	McanScheduler_Entry *entries; ///< Pending frame entries.
+	uint16_t *heap; ///< Priority heap, of entryCount elements.
+	uint16_t entryCount; ///< Number of entries.
+	/// \brief Data memory, entryCount blocks of maxDataSize bytes each.
+	uint8_t *dataMemory;
+	uint8_t maxDataSize; ///< Maximum data size of a frame.
+	/// \brief First dedicated Tx Buffer owned by the scheduler.
+	uint8_t firstBuffer;
+	/// \brief Number of dedicated Tx Buffers owned by the scheduler.
+	uint8_t bufferCount;
+	/// \brief Cancel the lowest priority frame pending in the Tx Buffers
+	///        when a frame of a higher priority waits for a free buffer.
+	bool isCancellationEnabled;
+} McanScheduler_Config;
+
+/// \brief Scheduler descriptor.
+typedef struct {
+	McanScheduler_Config config; ///< Configuration and storage.
+	uint16_t heapSize; ///< Number of frames waiting in the heap.
+	uint16_t freeEntry; ///< First free entry.
+	uint32_t sequence; ///< Sequence number of the next submitted frame.
+	uint32_t bufferMask; ///< Tx Buffers owned by the scheduler.
+	uint32_t busyMask; ///< Owned Tx Buffers with pending frames.
+	uint32_t cancelMask; ///< Owned Tx Buffers with requested cancellation.
+	/// \brief Entries held by the owned Tx Buffers.
+	uint16_t slots[MCAN_SCHEDULER_MAX_BUFFERS];
+	uint32_t cancelCount; ///< Number of frames returned by cancellation.
+} McanScheduler;
+
+/// \brief Initializes the scheduler and enables the cancellation finished
+///        interrupt of the owned Tx Buffers. The owned buffers shall be
+///        dedicated Tx Buffers not used otherwise, and the Transmission
+///        Completed and Transmission Cancellation Finished interrupts shall be
+///        enabled and handled by McanScheduler_handleInterrupt.
+/// \param [out] scheduler Scheduler descriptor.
+/// \param [in] config Scheduler configuration and storage.
+void McanScheduler_init(McanScheduler *const scheduler,
+		const McanScheduler_Config *const config);
+
+/// \brief Submits a frame for transmission. The frame data is copied, so the
+///        element can be reused after the call. Frames are sent in the order
+///        of their arbitration priority; frames with the same identifier are
+///        sent in the order of submission.
+/// \param [in] scheduler Scheduler descriptor.
+/// \param [in] element Tx element to send; the interrupt flag is ignored.
+/// \param [out] errCode An error code generated during the operation.
+/// \retval true Submitting the frame was successful.
+/// \retval false Submitting the frame failed.
+bool McanScheduler_submit(McanScheduler *const scheduler,
+		const Mcan_TxElement *const element, int *const errCode);
+
+/// \brief Reclaims the owned Tx Buffers which finished transmission or
+///        cancellation, refills them with the highest priority waiting
+///        frames and, if enabled, requests cancellation of a lower priority
+///        pending frame.
+/// \param [in] scheduler Scheduler descriptor.
+void McanScheduler_process(McanScheduler *const scheduler);
+
+/// \brief Interrupt callback calling McanScheduler_process, to be registered
+///        for Mcan_InterruptGroup_TxComplete with the scheduler as argument.
+/// \param [in] flags Raw interrupt flags.
+/// \param [in] arg Scheduler descriptor.
+void McanScheduler_handleInterrupt(uint32_t flags, void *arg);
+
+/// \brief Returns the number of frames not yet sent, including frames
+///        pending in the Tx Buffers.
+/// \param [in] scheduler Scheduler descriptor.
+/// \returns Number of pending frames.
+uint32_t McanScheduler_getPendingCount(const McanScheduler *const scheduler);
+
+#endif // BSP_MCAN_SCHEDULER_H
+
+/** @} */
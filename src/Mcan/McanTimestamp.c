@@ -0,0 +1,137 @@
+/**@file
+ * This file is part of the ARM BSP for the Test Environment.
+ *
+ * @copyright 2020-2021 N7 Space Sp. z o.o.
+ *
+ * Test Environment was developed under a programme of,
+ * and funded by, the European Space Agency (the "ESA").
+ *
+ *
+ * Licensed under the ESA Public License (ESA-PL) Permissive,
+ * Version 2.3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://essr.esa.int/license/list
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "McanTimestamp.h"
+
+#include <assert.h>
+#include <stddef.h>
+
+#define COUNTER_PERIOD 0x10000u
+
+static inline void
+memoryBarrier(void)
+{
+	asm volatile("dmb" ::: "memory");
+}
+
+/// \brief Disables interrupts, returning the previous PRIMASK value.
+static inline uint32_t
+lock(void)
+{
+	uint32_t primask;
+	asm volatile("mrs %0, primask\n"
+		     "cpsid i\n"
+			: "=r"(primask)
+			:
+			: "memory");
+	return primask;
+}
+
+/// \brief Restores PRIMASK saved by lock.
+static inline void
+unlock(const uint32_t primask)
+{
+	asm volatile("msr primask, %0\n" : : "r"(primask) : "memory");
+}
+
+static uint16_t
+readCounter(const McanTimestamp *const timestamp)
+{
+	if (timestamp->readCounter != NULL)
+		return timestamp->readCounter(timestamp->readCounterArg);
+	return (uint16_t)((timestamp->mcan->reg->tscv & MCAN_TSCV_TSC_MASK)
+			>> MCAN_TSCV_TSC_OFFSET);
+}
+
+void
+McanTimestamp_init(McanTimestamp *const timestamp, Mcan *const mcan,
+		const McanTimestampCounterReader counterReader,
+		void *const counterReaderArg)
+{
+	assert(timestamp != NULL);
+	assert((mcan != NULL) || (counterReader != NULL));
+
+	timestamp->mcan = mcan;
+	timestamp->readCounter = counterReader;
+	timestamp->readCounterArg = counterReaderArg;
+	timestamp->sequence = 0;
+	timestamp->wraparoundBase = 0;
+	timestamp->lastCounter = readCounter(timestamp);
+}
+
+void
+McanTimestamp_update(McanTimestamp *const timestamp)
+{
+	// Readers preempting the update would otherwise spin on the odd
+	// sequence forever, as the update cannot resume before they return.
+	const uint32_t primask = lock();
+
+	const uint16_t counter = readCounter(timestamp);
+	if (counter == timestamp->lastCounter) {
+		unlock(primask);
+		return;
+	}
+
+	timestamp->sequence++;
+	memoryBarrier();
+	if (counter < timestamp->lastCounter)
+		timestamp->wraparoundBase += COUNTER_PERIOD;
+	timestamp->lastCounter = counter;
+	memoryBarrier();
+	timestamp->sequence++;
+
+	unlock(primask);
+}
+
+uint64_t
+McanTimestamp_now(const McanTimestamp *const timestamp)
+{
+	uint32_t sequence;
+	uint64_t base;
+	uint16_t lastCounter;
+	uint16_t counter;
+
+	// The state is read again if an update interrupted the read.
+	do {
+		sequence = timestamp->sequence;
+		memoryBarrier();
+		base = timestamp->wraparoundBase;
+		lastCounter = timestamp->lastCounter;
+		counter = readCounter(timestamp);
+		memoryBarrier();
+	} while (((sequence & 1u) != 0u) || (sequence != timestamp->sequence));
+
+	// A wraparound not accounted for yet by an update. As the last update
+	// happened less than one counter period ago, at most one could occur.
+	if (counter < lastCounter)
+		base += COUNTER_PERIOD;
+	return base + counter;
+}
+
+uint64_t
+McanTimestamp_extend(const McanTimestamp *const timestamp, const uint16_t value)
+{
+	const uint64_t now = McanTimestamp_now(timestamp);
+	const uint16_t age = (uint16_t)((uint16_t)now - value);
+	return now - age;
+}
@@ -0,0 +1,115 @@
+/**@file
+ * This file is part of the ARM BSP for the Test Environment.
+ *
+ * @copyright 2020-2021 N7 Space Sp. z o.o.
+ *
+ * Test Environment was developed under a programme of,
+ * and funded by, the European Space Agency (the "ESA").
+ *
+ *
+ * Licensed under the ESA Public License (ESA-PL) Permissive,
+ * Version 2.3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://essr.esa.int/license/list
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @defgroup McanTimestamp McanTimestamp
+ * @ingroup Mcan
+ * @{
+ */
+
+#ifndef BSP_MCAN_TIMESTAMP_H
+#define BSP_MCAN_TIMESTAMP_H
+
+#include <stdint.h>
+
+#include "Mcan.h"
+
+/// \brief A function reading the 16-bit counter which timestamps the frames,
+///        used when the counter is not read from the MCAN registers.
+typedef uint16_t (*McanTimestampCounterReader)(void *arg);
+
+/// \brief Timestamp extension descriptor. The 16-bit counter is extended to
+///        64 bits by counting its wraparounds, detected as the counter value
+///        decreasing between two subsequent updates. This is unambiguous only
+///        if McanTimestamp_update is called at least twice per counter period,
+///        e.g. from a periodic timer interrupt; the Timestamp Wraparound
+///        interrupt alone is not sufficient, as its handler may run at any
+///        point of the period following the wraparound.
+typedef struct {
+	Mcan *mcan; ///< Mcan device descriptor.
+	McanTimestampCounterReader readCounter; ///< Counter reader, can be NULL.
+	void *readCounterArg; ///< Argument to the counter reader.
+	/// \brief Incremented before and after each update of the state.
+	volatile uint32_t sequence;
+	uint64_t wraparoundBase; ///< Counter wraparounds multiplied by 2^16.
+	uint16_t lastCounter; ///< Counter value seen by the last update.
+} McanTimestamp;
+
+/// \brief Initializes a timestamp extension descriptor.
+/// \param [out] timestamp Timestamp extension descriptor.
+/// \param [in] mcan Mcan device descriptor; its Timestamp Counter Value
+///        register is read, unless a counter reader is given.
+/// \param [in] counterReader Reader of the counter, e.g. of a Tic channel used
+///        as the external timestamp clock; NULL to use the MCAN counter.
+/// \param [in] counterReaderArg Argument to the counter reader.
+void McanTimestamp_init(McanTimestamp *const timestamp, Mcan *const mcan,
+		const McanTimestampCounterReader counterReader,
+		void *const counterReaderArg);
+
+/// \brief Accounts for a counter wraparound, if one occurred since the last
+///        update. Shall be called at least twice per counter period, always
+///        from the same single context, e.g. a periodic timer interrupt
+///        handler. Interrupts are disabled for the duration of the update.
+/// \param [in] timestamp Timestamp extension descriptor.
+void McanTimestamp_update(McanTimestamp *const timestamp);
+
+/// \brief Returns the current value of the extended counter. Safe to call
+///        from any context, provided that McanTimestamp_update is called as
+///        required.
+/// \param [in] timestamp Timestamp extension descriptor.
+/// \returns Extended 64-bit counter value.
+uint64_t McanTimestamp_now(const McanTimestamp *const timestamp);
+
+/// \brief Extends a 16-bit timestamp captured less than one counter period
+///        ago to 64 bits.
+/// \param [in] timestamp Timestamp extension descriptor.
+/// \param [in] value 16-bit timestamp, e.g. of an Rx or Tx Event element.
+/// \returns Extended 64-bit timestamp.
+uint64_t McanTimestamp_extend(
+		const McanTimestamp *const timestamp, const uint16_t value);
+
+/// \brief Returns the extended timestamp of an Rx element.
+/// \param [in] timestamp Timestamp extension descriptor.
+/// \param [in] element Rx element.
+/// \returns Extended 64-bit timestamp.
+static inline uint64_t
+McanTimestamp_extendRxElement(const McanTimestamp *const timestamp,
+		const Mcan_RxElement *const element)
+{
+	return McanTimestamp_extend(timestamp, element->timestamp);
+}
+
+/// \brief Returns the extended timestamp of a Tx Event element.
+/// \param [in] timestamp Timestamp extension descriptor.
+/// \param [in] element Tx Event element.
+/// \returns Extended 64-bit timestamp.
+static inline uint64_t
+McanTimestamp_extendTxEventElement(const McanTimestamp *const timestamp,
+		const Mcan_TxEventElement *const element)
+{
+	return McanTimestamp_extend(timestamp, element->timestamp);
+}
+
+#endif // BSP_MCAN_TIMESTAMP_H
+
+/** @} */
@@ -0,0 +1,124 @@
+/**@file
+ * This file is part of the ARM BSP for the Test Environment.
+ *
+ * @copyright 2020-2021 N7 Space Sp. z o.o.
+ *
+ * Test Environment was developed under a programme of,
+ * and funded by, the European Space Agency (the "ESA").
+ *
+ *
+ * Licensed under the ESA Public License (ESA-PL) Permissive,
+ * Version 2.3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://essr.esa.int/license/list
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "McanTxCompletion.h"
+
+#include <assert.h>
+#include <stddef.h>
+#include <string.h>
+
+#include <Utils/Utils.h>
+
+#define MARKER_WORD_BITS 32u
+#define MARKER_WORD_COUNT (MCAN_TX_COMPLETION_MARKER_COUNT / MARKER_WORD_BITS)
+
+void
+McanTxCompletion_init(McanTxCompletion *const completion,
+		const McanTxCompletion_Config *const config)
+{
+	memset(completion, 0, sizeof(McanTxCompletion));
+	completion->config = *config;
+	for (uint32_t i = 0; i < MARKER_WORD_COUNT; i++)
+		completion->freeMarkers[i] = UINT32_MAX;
+}
+
+bool
+McanTxCompletion_allocateMarker(McanTxCompletion *const completion,
+		void *const context, uint8_t *const marker, int *const errCode)
+{
+	for (uint32_t i = 0; i < MARKER_WORD_COUNT; i++) {
+		uint32_t *const word = &completion->freeMarkers[i];
+		uint32_t freeMask = __atomic_load_n(word, __ATOMIC_RELAXED);
+		while (freeMask != 0u) {
+			const uint32_t bit = (uint32_t)__builtin_ctz(freeMask);
+			const uint32_t mask = 1u << bit;
+			// The marker may be taken concurrently, in which case
+			// the next free one is tried.
+			freeMask = __atomic_fetch_and(
+					word, ~mask, __ATOMIC_ACQUIRE);
+			if ((freeMask & mask) != 0u) {
+				*marker = (uint8_t)((i * MARKER_WORD_BITS) + bit);
+				completion->contexts[*marker] = context;
+				return true;
+			}
+		}
+	}
+	return returnError(errCode, McanTxCompletion_ErrorCodes_NoFreeMarker);
+}
+
+void
+McanTxCompletion_freeMarker(
+		McanTxCompletion *const completion, const uint8_t marker)
+{
+	__atomic_fetch_or(&completion->freeMarkers[marker / MARKER_WORD_BITS],
+			1u << (marker % MARKER_WORD_BITS), __ATOMIC_RELEASE);
+}
+
+static bool
+isMarkerAllocated(const McanTxCompletion *const completion,
+		const uint8_t marker)
+{
+	const uint32_t freeMask = __atomic_load_n(
+			&completion->freeMarkers[marker / MARKER_WORD_BITS],
+			__ATOMIC_ACQUIRE);
+	return (freeMask & (1u << (marker % MARKER_WORD_BITS))) == 0u;
+}
+
+uint32_t
+McanTxCompletion_process(McanTxCompletion *const completion)
+{
+	const McanTxCompletion_Config *const config = &completion->config;
+	Mcan_TxEventElement events[MCAN_TX_COMPLETION_BATCH_SIZE];
+	uint32_t processedCount = 0;
+	uint32_t count = 0;
+	int errCode = 0;
+	while (Mcan_txEventFifoPullBatch(config->mcan, events,
+			MCAN_TX_COMPLETION_BATCH_SIZE, &count, &errCode)) {
+		if (config->batchCallback != NULL)
+			config->batchCallback(events, count, config->arg);
+
+		for (uint32_t i = 0; i < count; i++) {
+			const uint8_t marker = events[i].marker;
+			if (!isMarkerAllocated(completion, marker)) {
+				completion->unknownMarkerCount++;
+				continue;
+			}
+			void *const context = completion->contexts[marker];
+			McanTxCompletion_freeMarker(completion, marker);
+			if (config->callback != NULL)
+				config->callback(&events[i], context,
+						config->arg);
+		}
+		processedCount += count;
+		if (count < MCAN_TX_COMPLETION_BATCH_SIZE)
+			break;
+	}
+	return processedCount;
+}
+
+void
+McanTxCompletion_handleInterrupt(uint32_t flags, void *arg)
+{
+	(void)flags;
+	(void)McanTxCompletion_process((McanTxCompletion *)arg);
+}
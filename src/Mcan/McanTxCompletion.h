@@ -0,0 +1,128 @@
+/**@file
+ * This file is part of the ARM BSP for the Test Environment.
+ *
+ * @copyright 2020-2021 N7 Space Sp. z o.o.
+ *
+ * Test Environment was developed under a programme of,
+ * and funded by, the European Space Agency (the "ESA").
+ *
+ *
+ * Licensed under the ESA Public License (ESA-PL) Permissive,
+ * Version 2.3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://essr.esa.int/license/list
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @defgroup McanTxCompletion McanTxCompletion
+ * @ingroup Mcan
+ * @{
+ */
+
+#ifndef BSP_MCAN_TX_COMPLETION_H
+#define BSP_MCAN_TX_COMPLETION_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "Mcan.h"
+
+/// \brief Number of message markers.
+#define MCAN_TX_COMPLETION_MARKER_COUNT 256u
+
+/// \brief Maximum number of Tx Event FIFO elements pulled and acknowledged
+///        at once.
+#define MCAN_TX_COMPLETION_BATCH_SIZE 16u
+
+/// \brief Tx completion error codes.
+typedef enum {
+	/// \brief All message markers are in use.
+	McanTxCompletion_ErrorCodes_NoFreeMarker = 1,
+} McanTxCompletion_ErrorCodes;
+
+/// \brief A function serving as a callback called for each completed frame.
+/// \param [in] event Tx Event element of the frame.
+/// \param [in] context Context registered together with the frame marker.
+/// \param [in] arg Argument from the configuration.
+typedef void (*McanTxCompletionCallback)(
+		const Mcan_TxEventElement *event, void *context, void *arg);
+
+/// \brief A function serving as a callback called once for each batch of
+///        Tx Event elements, before the per-frame callbacks, e.g. to record
+///        transmission latencies in bulk.
+/// \param [in] events Tx Event elements.
+/// \param [in] count Number of elements.
+/// \param [in] arg Argument from the configuration.
+typedef void (*McanTxCompletionBatchCallback)(
+		const Mcan_TxEventElement *events, uint32_t count, void *arg);
+
+/// \brief Tx completion configuration.
+typedef struct {
+	Mcan *mcan; ///< Mcan device descriptor.
+	McanTxCompletionCallback callback; ///< Per-frame callback.
+	McanTxCompletionBatchCallback batchCallback; ///< Optional batch callback.
+	void *arg; ///< Argument to the callbacks.
+} McanTxCompletion_Config;
+
+/// \brief Tx completion engine descriptor.
+typedef struct {
+	McanTxCompletion_Config config; ///< Configuration.
+	/// \brief Contexts of the allocated message markers.
+	void *contexts[MCAN_TX_COMPLETION_MARKER_COUNT];
+	/// \brief Bitmap of free message markers.
+	uint32_t freeMarkers[MCAN_TX_COMPLETION_MARKER_COUNT / 32u];
+	/// \brief Number of events carrying a marker which was not allocated.
+	uint32_t unknownMarkerCount;
+} McanTxCompletion;
+
+/// \brief Initializes the Tx completion engine with all markers free.
+/// \param [out] completion Tx completion engine descriptor.
+/// \param [in] config Configuration.
+void McanTxCompletion_init(McanTxCompletion *const completion,
+		const McanTxCompletion_Config *const config);
+
+/// \brief Allocates a message marker for a frame. The marker shall be set in
+///        the Tx element (or template, using Mcan_txTemplateSetMarker) with
+///        the Tx Event storing enabled; it is freed when its event is
+///        processed. May be called concurrently with McanTxCompletion_process.
+/// \param [in] completion Tx completion engine descriptor.
+/// \param [in] context Context passed to the per-frame callback.
+/// \param [out] marker Allocated message marker.
+/// \param [out] errCode An error code generated during the operation.
+/// \retval true Allocating the marker was successful.
+/// \retval false Allocating the marker failed.
+bool McanTxCompletion_allocateMarker(McanTxCompletion *const completion,
+		void *const context, uint8_t *const marker, int *const errCode);
+
+/// \brief Frees a message marker of a frame which will produce no Tx Event,
+///        e.g. after its transmission was cancelled.
+/// \param [in] completion Tx completion engine descriptor.
+/// \param [in] marker Message marker.
+void McanTxCompletion_freeMarker(
+		McanTxCompletion *const completion, const uint8_t marker);
+
+/// \brief Drains the Tx Event FIFO in batches of up to
+///        MCAN_TX_COMPLETION_BATCH_SIZE elements, each acknowledged with a
+///        single write, and calls the callbacks for the pulled elements.
+/// \param [in] completion Tx completion engine descriptor.
+/// \returns Number of processed events.
+uint32_t McanTxCompletion_process(McanTxCompletion *const completion);
+
+/// \brief Interrupt callback calling McanTxCompletion_process, to be
+///        registered for Mcan_InterruptGroup_TxEvent with the engine as
+///        argument.
+/// \param [in] flags Raw interrupt flags.
+/// \param [in] arg Tx completion engine descriptor.
+void McanTxCompletion_handleInterrupt(uint32_t flags, void *arg);
+
+#endif // BSP_MCAN_TX_COMPLETION_H
+
+/** @} */
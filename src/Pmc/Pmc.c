@@ -413,3 +413,78 @@ Pmc_measureMainck(Pmc_MainckMeasurement *data)
 					     * data->refFreq)
 			/ CKGR_MCFR_MAINF_DIVIDER;
 }
+
+static uint32_t
+getMainckFreq(const Pmc_Config *const config)
+{
+	if (config->mainckSrc != Pmc_MainckSrc_RcOsc)
+		return PMC_MAIN_CRYSTAL_FREQ;
+
+	switch (config->rcOscFreq) {
+	case Pmc_RcOscFreq_4M: return 4000000u;
+	case Pmc_RcOscFreq_8M: return 8000000u;
+	case Pmc_RcOscFreq_12M: return 12000000u;
+	}
+	return 0;
+}
+
+static uint32_t
+getPllackFreq(const Pmc_Config *const config)
+{
+	if ((config->pllaDiv == 0u) || (config->pllaMul == 0u))
+		return 0;
+
+	return (uint32_t)(((uint64_t)getMainckFreq(config)
+					  * ((uint64_t)config->pllaMul + 1u))
+			/ config->pllaDiv);
+}
+
+static uint32_t
+decodeMasterckPresc(const Pmc_MasterckPresc presc)
+{
+	if (presc == Pmc_MasterckPresc_3)
+		return 3u;
+	return 1u << (uint32_t)presc;
+}
+
+static uint32_t
+getMasterckSrcFreq(const Pmc_Config *const config)
+{
+	switch (config->masterckSrc) {
+	case Pmc_MasterckSrc_Slck: return PMC_SLOW_CLOCK_FREQ;
+	case Pmc_MasterckSrc_Mainck: return getMainckFreq(config);
+	case Pmc_MasterckSrc_Pllack: return getPllackFreq(config);
+	}
+	return 0;
+}
+
+uint32_t
+Pmc_getMasterckFreq(const Pmc_Config *const config)
+{
+	const uint32_t processorClkFreq = getMasterckSrcFreq(config)
+			/ decodeMasterckPresc(config->masterckPresc);
+
+	if (config->masterckDiv == Pmc_MasterckDiv_2)
+		return processorClkFreq / 2u;
+	return processorClkFreq;
+}
+
+uint32_t
+Pmc_getPckFreq(const Pmc_Config *const config, const uint32_t pckIndex)
+{
+	assert(pckIndex < PMC_PCK_CLOCKS);
+
+	const Pmc_PckConfig *const pck = &config->pckConfig[pckIndex];
+	if (!pck->isEnabled)
+		return 0;
+
+	uint32_t srcFreq = 0;
+	switch (pck->pckSrc) {
+	case Pmc_PckSrc_Slck: srcFreq = PMC_SLOW_CLOCK_FREQ; break;
+	case Pmc_PckSrc_Mainck: srcFreq = getMainckFreq(config); break;
+	case Pmc_PckSrc_Pllack: srcFreq = getPllackFreq(config); break;
+	case Pmc_PckSrc_Masterck: srcFreq = Pmc_getMasterckFreq(config); break;
+	}
+
+	return srcFreq / ((uint32_t)pck->pckPresc + 1u);
+}
@@ -173,6 +173,19 @@ bool Pmc_isPeripheralClkEnabled(const Pmc_PeripheralId peripheralId);
 /// the system. \param [in,out] data Pointer to a measurement descriptor.
 void Pmc_measureMainck(Pmc_MainckMeasurement *data);
 
+/// \brief Function used to calculate the master clock (MCK) frequency
+/// resulting from a configuration.
+/// \param [in] config PMC configuration descriptor.
+/// \returns Master clock frequency in Hz.
+uint32_t Pmc_getMasterckFreq(const Pmc_Config *const config);
+
+/// \brief Function used to calculate the frequency of a programmable clock
+/// resulting from a configuration.
+/// \param [in] config PMC configuration descriptor.
+/// \param [in] pckIndex Index of the programmable clock.
+/// \returns Programmable clock frequency in Hz, 0 if the clock is disabled.
+uint32_t Pmc_getPckFreq(const Pmc_Config *const config, const uint32_t pckIndex);
+
 #endif // BSP_PMC_H
 
 /** @} */
@@ -0,0 +1,186 @@
+/**@file
+ * This file is part of the ARM BSP for the Test Environment.
+ *
+ * @copyright 2020-2021 N7 Space Sp. z o.o.
+ *
+ * Test Environment was developed under a programme of,
+ * and funded by, the European Space Agency (the "ESA").
+ *
+ *
+ * Licensed under the ESA Public License (ESA-PL) Permissive,
+ * Version 2.3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://essr.esa.int/license/list
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "CoverageTransport.h"
+
+#include <string.h>
+
+#define BASE64_LINE_LENGTH 76u
+#define RLE_MAX_RUN 255u
+
+static inline void
+writeString(const CoverageTransport *const transport, const char *string)
+{
+	while (*string != '\0') {
+		transport->writer((uint8_t)*string);
+		string++;
+	}
+}
+
+static inline uint8_t
+nibbleToHex(const uint8_t value)
+{
+	if (value < 10u)
+		return (uint8_t)(value + '0');
+	return (uint8_t)(value - 10u + 'A');
+}
+
+static inline uint8_t
+toBase64(const uint32_t value)
+{
+	static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+				       "abcdefghijklmnopqrstuvwxyz"
+				       "0123456789+/";
+	return (uint8_t)alphabet[value & 0x3Fu];
+}
+
+static inline void
+writeBase64Group(CoverageTransport *const transport)
+{
+	const uint32_t bits = ((uint32_t)transport->group[0] << 16u)
+			| ((uint32_t)transport->group[1] << 8u)
+			| (uint32_t)transport->group[2];
+
+	transport->writer(toBase64(bits >> 18u));
+	transport->writer(toBase64(bits >> 12u));
+	transport->writer((transport->groupLength > 1u) ? toBase64(bits >> 6u)
+							: (uint8_t)'=');
+	transport->writer((transport->groupLength > 2u) ? toBase64(bits)
+							: (uint8_t)'=');
+
+	transport->lineLength += 4u;
+	if (transport->lineLength >= BASE64_LINE_LENGTH) {
+		transport->writer('\n');
+		transport->lineLength = 0;
+	}
+
+	memset(transport->group, 0, sizeof(transport->group));
+	transport->groupLength = 0;
+}
+
+static inline void
+writeBlock(CoverageTransport *const transport)
+{
+	transport->writer((uint8_t)transport->blockLength);
+	for (uint32_t i = 0; i < transport->blockLength; i++)
+		transport->writer(transport->block[i]);
+	transport->blockLength = 0;
+}
+
+static void
+encodeByte(CoverageTransport *const transport, const uint8_t data)
+{
+#if COVERAGE_ENCODING == COVERAGE_ENCODING_HEX
+	transport->writer(nibbleToHex((data >> 4u) & 0x0Fu));
+	transport->writer(nibbleToHex(data & 0x0Fu));
+#elif COVERAGE_ENCODING == COVERAGE_ENCODING_BASE64
+	transport->group[transport->groupLength] = data;
+	transport->groupLength++;
+	if (transport->groupLength == sizeof(transport->group))
+		writeBase64Group(transport);
+#elif COVERAGE_ENCODING == COVERAGE_ENCODING_RAW
+	transport->block[transport->blockLength] = data;
+	transport->blockLength++;
+	if (transport->blockLength == COVERAGE_TRANSPORT_BLOCK_SIZE)
+		writeBlock(transport);
+#else
+#error "Unknown COVERAGE_ENCODING"
+#endif
+}
+
+static void
+flushZeroRun(CoverageTransport *const transport)
+{
+	if (transport->zeroRun == 0u)
+		return;
+
+	// A zero byte is always followed by the length of its run.
+	encodeByte(transport, 0u);
+	encodeByte(transport, (uint8_t)transport->zeroRun);
+	transport->zeroRun = 0;
+}
+
+static inline void
+compressByte(CoverageTransport *const transport, const uint8_t data)
+{
+#if COVERAGE_RLE_ENABLED
+	if (data == 0u) {
+		transport->zeroRun++;
+		if (transport->zeroRun == RLE_MAX_RUN)
+			flushZeroRun(transport);
+		return;
+	}
+	flushZeroRun(transport);
+#endif
+	encodeByte(transport, data);
+}
+
+void
+CoverageTransport_begin(CoverageTransport *const transport,
+		const CoverageTransport_ByteWriter writer)
+{
+	memset(transport, 0, sizeof(CoverageTransport));
+	transport->writer = writer;
+
+#if !COVERAGE_LEGACY_FORMAT
+#if COVERAGE_ENCODING == COVERAGE_ENCODING_BASE64
+	writeString(transport, "@base64");
+#elif COVERAGE_ENCODING == COVERAGE_ENCODING_RAW
+	writeString(transport, "@raw");
+#else
+	writeString(transport, "@hex");
+#endif
+#if COVERAGE_RLE_ENABLED
+	writeString(transport, "+rle");
+#endif
+	transport->writer('\n');
+#endif
+}
+
+void
+CoverageTransport_write(CoverageTransport *const transport,
+		const uint8_t *const data, const uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i++)
+		compressByte(transport, data[i]);
+}
+
+void
+CoverageTransport_end(CoverageTransport *const transport)
+{
+	flushZeroRun(transport);
+
+#if COVERAGE_ENCODING == COVERAGE_ENCODING_BASE64
+	if (transport->groupLength > 0u)
+		writeBase64Group(transport);
+#elif COVERAGE_ENCODING == COVERAGE_ENCODING_RAW
+	if (transport->blockLength > 0u)
+		writeBlock(transport);
+	// An empty block terminates the binary data.
+	writeBlock(transport);
+#endif
+
+#if !COVERAGE_LEGACY_FORMAT
+	writeString(transport, "\n<<<\n");
+#endif
+}
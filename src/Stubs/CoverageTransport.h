@@ -0,0 +1,92 @@
+/**@file
+ * This file is part of the ARM BSP for the Test Environment.
+ *
+ * @copyright 2020-2021 N7 Space Sp. z o.o.
+ *
+ * Test Environment was developed under a programme of,
+ * and funded by, the European Space Agency (the "ESA").
+ *
+ *
+ * Licensed under the ESA Public License (ESA-PL) Permissive,
+ * Version 2.3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://essr.esa.int/license/list
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/// \brief Encoder of the coverage data written by gcov through the Stubs
+/// low-level IO, decoded on the host by tools/coverage_decode.py.
+
+#ifndef STUBS_COVERAGE_TRANSPORT_H
+#define STUBS_COVERAGE_TRANSPORT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/// \brief Coverage encoding: two hex characters per byte (legacy).
+#define COVERAGE_ENCODING_HEX 0
+/// \brief Coverage encoding: base64, safe for text-only channels.
+#define COVERAGE_ENCODING_BASE64 1
+/// \brief Coverage encoding: length-prefixed raw binary blocks.
+#define COVERAGE_ENCODING_RAW 2
+
+#ifndef COVERAGE_ENCODING
+/// \brief Default coverage encoding if not specified
+#define COVERAGE_ENCODING COVERAGE_ENCODING_HEX
+#endif
+
+#ifndef COVERAGE_RLE_ENABLED
+/// \brief Whether zero runs are compressed before encoding, by default
+/// enabled for base64 and raw encodings.
+#define COVERAGE_RLE_ENABLED (COVERAGE_ENCODING != COVERAGE_ENCODING_HEX)
+#endif
+
+/// \brief Whether the dump uses the legacy format, i.e. uncompressed hex
+/// without the encoding tag and terminator lines.
+#define COVERAGE_LEGACY_FORMAT \
+	((COVERAGE_ENCODING == COVERAGE_ENCODING_HEX) && !COVERAGE_RLE_ENABLED)
+
+/// \brief Maximum length of a raw binary block.
+#define COVERAGE_TRANSPORT_BLOCK_SIZE 255u
+
+/// \brief A function writing a single byte to the low-level IO.
+typedef void (*CoverageTransport_ByteWriter)(uint8_t byte);
+
+/// \brief Coverage encoder state, kept between _write calls of a file.
+typedef struct {
+	CoverageTransport_ByteWriter writer; ///< Output byte writer.
+	uint8_t group[3]; ///< Bytes pending base64 encoding.
+	uint32_t groupLength; ///< Number of pending base64 bytes.
+	uint32_t lineLength; ///< Number of characters in the current line.
+	uint32_t zeroRun; ///< Length of the pending run of zero bytes.
+	uint8_t block[COVERAGE_TRANSPORT_BLOCK_SIZE]; ///< Pending raw block.
+	uint32_t blockLength; ///< Number of bytes in the pending raw block.
+} CoverageTransport;
+
+/// \brief Starts encoding of a coverage file, writing the encoding tag line
+/// unless the legacy format is used.
+/// \param [out] transport Encoder state.
+/// \param [in] writer Output byte writer.
+void CoverageTransport_begin(CoverageTransport *const transport,
+		const CoverageTransport_ByteWriter writer);
+
+/// \brief Encodes a chunk of coverage data.
+/// \param [in,out] transport Encoder state.
+/// \param [in] data Coverage data.
+/// \param [in] count Number of bytes.
+void CoverageTransport_write(CoverageTransport *const transport,
+		const uint8_t *const data, const uint32_t count);
+
+/// \brief Flushes pending data and writes the end-of-file marker, unless the
+/// legacy format is used.
+/// \param [in,out] transport Encoder state.
+void CoverageTransport_end(CoverageTransport *const transport);
+
+#endif // STUBS_COVERAGE_TRANSPORT_H
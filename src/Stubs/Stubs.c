@@ -30,12 +30,20 @@
 #include <Pmc/Pmc.h>
 #include <SystemConfig/SystemConfig.h>
 
-#if defined(USE_UART_IO)
+#if defined(USE_USB_USART_IO)
+#include <Usart/Usart.h>
+#elif defined(USE_UART_IO)
 #include <Uart/Uart.h>
 #elif defined(USE_SDRAM_IO)
 #include <Sdramc/Sdramc.h>
 #endif
 
+#if defined(USE_BUFFERED_IO)
+#include <Nvic/Nvic.h>
+#include <Utils/ByteFifo.h>
+#endif
+
+#include "CoverageTransport.h"
 #include "Stubs.h"
 
 #define GCOV_DUMMY_FD 0
@@ -49,7 +57,17 @@ extern void __gcov_flush(void);
 extern int _eheap;
 extern int _sheap;
 
+static CoverageTransport Stubs_coverageTransport;
+
+#if defined(USE_UART_IO) || defined(USE_USB_USART_IO)
+static void startBuffering(void);
+static void stopBuffering(void);
+#endif
+
 #if defined(USE_USB_USART_IO)
+
+static Usart Stubs_usart;
+
 static inline void
 configurePioPins(void)
 {
@@ -78,68 +96,78 @@ Stubs_startup(void)
 	Pmc_enablePeripheralClk(Pmc_PeripheralId_Usart1);
 	configurePioPins();
 
-	volatile uint32_t *const US_CR = (uint32_t *)0x40028000; // USART_1
-	volatile uint32_t *const US_MR = (uint32_t *)0x40028004;
-	volatile uint32_t *const US_BRGR = (uint32_t *)0x40028020;
-
-	*US_MR = 0; // Clear
-	*US_MR |= 0u << 0; // USART_MODE NORMAL
-	*US_MR |= 0u << 4; // USCLKS PCK
-	*US_MR |= 3u << 6; // CHRL 8BIT
-	*US_MR |= 0u << 8; // SYNC Asynchronous
-	*US_MR |= 4u << 9; // PAR No parity
-	*US_MR |= 0u << 12; // NBSTOP 1 stop bit
-	*US_MR |= 0u << 14; // CHMODE Normal mode
-	*US_MR |= 0u << 16; // MSBF MSB
-	*US_MR |= 0u << 17; // MODE9 CHRL defines length
-	*US_MR |= 0u << 18; // CLKO does not drive SCK pin
-	*US_MR |= 0u << 19; // OVER 16x oversampling
-	*US_MR |= 1u << 20; // INACK NSCK is not generated
-	*US_MR |= 0u << 21; // DSNACK don't care - no NACK
-	*US_MR |= 0u << 22; // VAR_SYNC MODSYNC defines sync
-	*US_MR |= 0u << 23; // INVDATA do not invert data
-	*US_MR |= 0u << 24; // MAX_ITERATION don't care - valid in ISO7816 protocol
-	*US_MR |= 0u << 28; // FILTER do not filter incomming data
-	*US_MR |= 0u << 29; // MAN manchester coding disabled
-	*US_MR |= 0u << 30; // MODSYNC don't care - manchester disabled
-	*US_MR |= 1u << 31; // ONEBIT 1 bit start frame delimiter
-
-	// BaudRate = CLK / ((coarseDiv + fineDiv / 8) * 16)
-	uint32_t coarseDiv = SystemConfig_DefaultPeriphClock
-			/ (16u * LOW_LEVEL_IO_BAUDRATE);
-	uint64_t fineDiv = 8uLL
-			* (((uint64_t)SystemConfig_DefaultPeriphClock * 1000uLL
-					   / (16uLL * LOW_LEVEL_IO_BAUDRATE))
-					- (uint64_t)coarseDiv * 1000uLL);
-	fineDiv /= 1000uLL;
-
-	*US_BRGR = coarseDiv | ((uint32_t)fineDiv << 16u);
-	*US_CR = 1u << 6u; // Enable the transmitter
+	Usart_Config conf = { 0 };
+	conf.isTxEnabled = true;
+	conf.isRxEnabled = false;
+	conf.isTestModeEnabled = false;
+	conf.isHardwareHandshakingEnabled = false;
+	conf.parity = Usart_Parity_None;
+	conf.charLength = Usart_CharLength_8;
+	conf.stopBits = Usart_StopBits_1;
+	conf.baudRate = LOW_LEVEL_IO_BAUDRATE;
+	conf.baudRateClkSrc = Usart_BaudRateClk_PeripheralCk;
+	conf.baudRateClkFreq = SystemConfig_DefaultPeriphClock;
+	conf.rxTimeout = 0;
+
+	Usart_init(Usart_Id_1, &Stubs_usart);
+	Usart_startup(&Stubs_usart);
+	const bool isConfigured = Usart_setConfig(&Stubs_usart, &conf, NULL);
+	assert(isConfigured);
+	(void)isConfigured;
+	startBuffering();
 }
 
 void
 Stubs_shutdown(void)
 {
+	stopBuffering();
+	Usart_shutdown(&Stubs_usart);
 	Pmc_disablePeripheralClk(Pmc_PeripheralId_Usart1);
 }
 
-static void
-waitForTransmitterReady(void)
+static inline void
+waitForTransmitterIdle(void)
 {
-	volatile uint32_t *const US_CSR = (uint32_t *)0x40028014;
-	while (((*US_CSR) & 0x00000002) == 0)
+	while (!Usart_isTxEmpty(&Stubs_usart))
 		asm volatile("nop");
 }
 
-static void
-writeByte(const uint8_t data)
+static inline void
+writeByteSync(const uint8_t data)
 {
-	waitForTransmitterReady();
+	Usart_write(&Stubs_usart, data, 10000000, NULL);
+}
+
+#if defined(USE_BUFFERED_IO)
+static inline Nvic_Irq
+getIrq(void)
+{
+	return Nvic_Irq_Usart1;
+}
 
-	volatile uint32_t *const US_THR = (uint32_t *)0x4002801C;
-	*US_THR = data;
+static inline bool
+isTransmitterActive(void)
+{
+	return Stubs_usart.txFifo != NULL;
 }
 
+static inline void
+startTransmission(ByteFifo *const fifo)
+{
+	const Usart_TxHandler handler = { NULL, NULL };
+	const bool isStarted =
+			Usart_writeAsync(&Stubs_usart, fifo, handler, NULL);
+	assert(isStarted);
+	(void)isStarted;
+}
+
+static void
+handleInterrupt(void)
+{
+	Usart_handleInterrupt(&Stubs_usart);
+}
+#endif
+
 #elif defined(USE_UART_IO)
 
 static Uart Stubs_uart;
@@ -172,6 +200,14 @@ configureUart(void)
 	conf.baudRateClkSrc = Uart_BaudRateClk_PeripheralCk;
 	conf.baudRateClkFreq = SystemConfig_DefaultPeriphClock;
 
+	// Use the UART/USART PCK instead of the peripheral clock if it
+	// generates the baud rate more accurately.
+	const Pmc_Config pmcConf = SystemConfig_getPmcDefaultConfig();
+	Uart_BaudRateInfo baudRateInfo;
+	Uart_selectBaudRateClk(&conf, SystemConfig_DefaultPeriphClock,
+			Pmc_getPckFreq(&pmcConf, SystemConfig_UartPckIndex),
+			&baudRateInfo, NULL);
+
 	Uart_init(LOW_LEVEL_IO_UART_ID, &Stubs_uart);
 	Uart_setConfig(&Stubs_uart, &conf);
 }
@@ -220,25 +256,61 @@ Stubs_startup(void)
 	default: assert(false);
 	}
 	configureUart();
+	startBuffering();
 }
 
 static inline void
-writeByte(const uint8_t data)
+writeByteSync(const uint8_t data)
 {
 	Uart_write(&Stubs_uart, data, 10000000, NULL);
 }
 
 static inline void
-waitForTransmitterReady(void)
+waitForTransmitterIdle(void)
 {
 	while ((Uart_getStatusRegister(&Stubs_uart) & UART_SR_TXEMPTY_MASK)
-			!= 0u)
+			== 0u)
 		;
 }
 
+#if defined(USE_BUFFERED_IO)
+static inline Nvic_Irq
+getIrq(void)
+{
+	switch (LOW_LEVEL_IO_UART_ID) {
+	case Uart_Id_0: return Nvic_Irq_Uart0;
+	case Uart_Id_1: return Nvic_Irq_Uart1;
+	case Uart_Id_2: return Nvic_Irq_Uart2;
+	case Uart_Id_3: return Nvic_Irq_Uart3;
+	case Uart_Id_4: return Nvic_Irq_Uart4;
+	default: assert(false); return Nvic_Irq_Uart0;
+	}
+}
+
+static inline bool
+isTransmitterActive(void)
+{
+	return Stubs_uart.txFifo != NULL;
+}
+
+static inline void
+startTransmission(ByteFifo *const fifo)
+{
+	const Uart_TxHandler handler = { NULL, NULL };
+	Uart_writeAsync(&Stubs_uart, fifo, handler);
+}
+
+static void
+handleInterrupt(void)
+{
+	Uart_handleInterrupt(&Stubs_uart);
+}
+#endif
+
 void
 Stubs_shutdown(void)
 {
+	stopBuffering();
 	Uart_shutdown(&Stubs_uart);
 
 	switch (LOW_LEVEL_IO_UART_ID) {
@@ -255,7 +327,24 @@ Stubs_shutdown(void)
 
 extern uint8_t sdramMemory_begin;
 extern uint8_t sdramMemory_end;
+
+#if defined(LOW_LEVEL_IO_SDRAM_RING)
+/// \brief Header preceding the stdout ring in SDRAM. The host reader polls
+/// the sequence, which is the total number of bytes written; the newest byte
+/// is stored at offset (sequence - 1) % capacity.
+typedef struct {
+	uint32_t magic; ///< LOW_LEVEL_IO_SDRAM_RING_MAGIC.
+	volatile uint32_t sequence; ///< Total number of bytes written.
+	uint32_t capacity; ///< Size of the ring in bytes.
+	uint32_t reserved; ///< Keeps the ring word-aligned.
+} StdoutRingHeader;
+
+static volatile StdoutRingHeader *stdoutRingHeader;
+static uint32_t stdoutRingOffset;
+#else
 static volatile uint32_t *stdoutByteCountPtr;
+static volatile uint32_t Stubs_droppedByteCount;
+#endif
 static volatile uint8_t *stdoutArray;
 static volatile uint32_t stdoutArraySize;
 
@@ -393,12 +482,6 @@ configureSdramc(Sdramc *const sdramc)
 void
 Stubs_startup(void)
 {
-	stdoutArraySize = (uint32_t)&sdramMemory_end
-			- (uint32_t)&sdramMemory_begin - sizeof(uint32_t);
-	stdoutByteCountPtr = (uint32_t *)((uint32_t)&sdramMemory_begin);
-	stdoutArray = (uint8_t *)((uint32_t)&sdramMemory_begin
-			+ sizeof(uint32_t));
-
 	configurePio();
 	configureClock();
 	Sdramc_init(&Stubs_sdramc);
@@ -410,6 +493,29 @@ Stubs_startup(void)
 	memset(&sdramMemory_begin, 0,
 			(uint32_t)&sdramMemory_end
 					- (uint32_t)&sdramMemory_begin);
+
+#if defined(LOW_LEVEL_IO_SDRAM_RING)
+	stdoutArraySize = (uint32_t)&sdramMemory_end
+			- (uint32_t)&sdramMemory_begin
+			- sizeof(StdoutRingHeader);
+	stdoutRingHeader = (StdoutRingHeader *)((uint32_t)&sdramMemory_begin);
+	stdoutArray = (uint8_t *)((uint32_t)&sdramMemory_begin
+			+ sizeof(StdoutRingHeader));
+	stdoutRingOffset = 0;
+
+	stdoutRingHeader->capacity = stdoutArraySize;
+	stdoutRingHeader->sequence = 0;
+	asm volatile("dmb");
+	// The magic is written last, so that the reader never sees a partially
+	// initialized header.
+	stdoutRingHeader->magic = LOW_LEVEL_IO_SDRAM_RING_MAGIC;
+#else
+	stdoutArraySize = (uint32_t)&sdramMemory_end
+			- (uint32_t)&sdramMemory_begin - sizeof(uint32_t);
+	stdoutByteCountPtr = (uint32_t *)((uint32_t)&sdramMemory_begin);
+	stdoutArray = (uint8_t *)((uint32_t)&sdramMemory_begin
+			+ sizeof(uint32_t));
+#endif
 }
 
 void
@@ -420,14 +526,99 @@ Stubs_shutdown(void)
 }
 
 static void
-writeByte(const uint8_t data)
+copyToSdram(const uint32_t offset, const uint8_t *data, uint32_t count)
+{
+	volatile uint8_t *destination = &stdoutArray[offset];
+
+	while ((count > 0u) && (((uint32_t)destination & 0x3u) != 0u)) {
+		*destination = *data;
+		destination++;
+		data++;
+		count--;
+	}
+
+	// Word writes let the SDRAM controller burst; the source may be
+	// unaligned, which is supported by the core.
+	volatile uint32_t *wordDestination = (volatile uint32_t *)destination;
+	while (count >= sizeof(uint32_t)) {
+		uint32_t word;
+		memcpy(&word, data, sizeof(uint32_t));
+		*wordDestination = word;
+		wordDestination++;
+		data += sizeof(uint32_t);
+		count -= (uint32_t)sizeof(uint32_t);
+	}
+
+	destination = (volatile uint8_t *)wordDestination;
+	while (count > 0u) {
+		*destination = *data;
+		destination++;
+		data++;
+		count--;
+	}
+}
+
+#if defined(LOW_LEVEL_IO_SDRAM_RING)
+static void
+writeBytes(const uint8_t *data, uint32_t count)
 {
-	stdoutArray[*stdoutByteCountPtr] = data;
-	++(*stdoutByteCountPtr);
-	if (*stdoutByteCountPtr > (uint32_t)(stdoutArray + stdoutArraySize)) {
-		--(*stdoutByteCountPtr);
-		assert(false);
+	const uint32_t totalCount = count;
+
+	// Only the newest bytes fit in the ring.
+	if (count > stdoutArraySize) {
+		data += count - stdoutArraySize;
+		stdoutRingOffset = (stdoutRingOffset + count - stdoutArraySize)
+				% stdoutArraySize;
+		count = stdoutArraySize;
 	}
+
+	const uint32_t firstChunk = (count < (stdoutArraySize - stdoutRingOffset))
+			? count
+			: (stdoutArraySize - stdoutRingOffset);
+	copyToSdram(stdoutRingOffset, data, firstChunk);
+	copyToSdram(0, data + firstChunk, count - firstChunk);
+
+	stdoutRingOffset += count;
+	if (stdoutRingOffset >= stdoutArraySize)
+		stdoutRingOffset -= stdoutArraySize;
+
+	// Publish the data before the sequence, so that the reader never
+	// consumes bytes that are not written yet.
+	asm volatile("dmb");
+	stdoutRingHeader->sequence += totalCount;
+}
+
+uint32_t
+Stubs_getDroppedByteCount(void)
+{
+	return 0;
+}
+#else
+static void
+writeBytes(const uint8_t *const data, const uint32_t count)
+{
+	const uint32_t byteCount = *stdoutByteCountPtr;
+	const uint32_t freeSpace = stdoutArraySize - byteCount;
+	const uint32_t writtenCount = (count < freeSpace) ? count : freeSpace;
+
+	copyToSdram(byteCount, data, writtenCount);
+
+	asm volatile("dmb");
+	*stdoutByteCountPtr = byteCount + writtenCount;
+	Stubs_droppedByteCount += count - writtenCount;
+}
+
+uint32_t
+Stubs_getDroppedByteCount(void)
+{
+	return Stubs_droppedByteCount;
+}
+#endif
+
+static void
+writeByte(const uint8_t data)
+{
+	writeBytes(&data, 1u);
 }
 
 static void
@@ -441,6 +632,166 @@ waitForTransmitterReady(void)
 #error "Usage of stdio would result in a crash, as low level IO interface was not selected with proper #define"
 #endif
 
+#if defined(USE_BUFFERED_IO)
+
+#if !defined(USE_UART_IO) && !defined(USE_USB_USART_IO)
+#error "Buffered low level IO requires UART or USB USART IO"
+#endif
+
+static uint8_t Stubs_txBuffer[LOW_LEVEL_IO_BUFFER_SIZE];
+static ByteFifo Stubs_txFifo;
+static volatile uint32_t Stubs_droppedByteCount;
+
+static inline void
+lockTransmitter(const Nvic_Irq irq)
+{
+	Nvic_disableInterrupt(irq);
+	asm volatile("dsb");
+	asm volatile("isb");
+}
+
+static inline void
+unlockTransmitter(const Nvic_Irq irq)
+{
+	Nvic_enableInterrupt(irq);
+}
+
+static void
+startBuffering(void)
+{
+	ByteFifo_init(&Stubs_txFifo, Stubs_txBuffer, sizeof(Stubs_txBuffer));
+	Stubs_droppedByteCount = 0;
+
+	Nvic_setInterruptHandlerAddress(getIrq(), handleInterrupt);
+	Nvic_enableInterrupt(getIrq());
+}
+
+static void
+stopBuffering(void)
+{
+	Stubs_flush();
+	Nvic_disableInterrupt(getIrq());
+}
+
+static inline void
+makeRoom(void)
+{
+	uint8_t oldest = 0;
+	(void)ByteFifo_pull(&Stubs_txFifo, &oldest);
+#if LOW_LEVEL_IO_OVERFLOW_POLICY == LOW_LEVEL_IO_OVERFLOW_BLOCK
+	// The interrupt is masked, so instead of waiting for it to drain the
+	// queue, the oldest byte is sent synchronously. This also works when
+	// called with interrupts disabled.
+	writeByteSync(oldest);
+#else
+	Stubs_droppedByteCount++;
+#endif
+}
+
+static void
+writeByte(const uint8_t data)
+{
+	const Nvic_Irq irq = getIrq();
+	lockTransmitter(irq);
+
+	if (ByteFifo_isFull(&Stubs_txFifo)) {
+#if LOW_LEVEL_IO_OVERFLOW_POLICY == LOW_LEVEL_IO_OVERFLOW_DROP
+		Stubs_droppedByteCount++;
+		unlockTransmitter(irq);
+		return;
+#else
+		makeRoom();
+#endif
+	}
+
+	(void)ByteFifo_push(&Stubs_txFifo, data);
+	if (!isTransmitterActive())
+		startTransmission(&Stubs_txFifo);
+
+	unlockTransmitter(irq);
+}
+
+static inline void
+waitForTransmitterReady(void)
+{
+	// Buffered output is drained by the interrupt, _write does not wait.
+}
+
+void
+Stubs_flush(void)
+{
+	const Nvic_Irq irq = getIrq();
+	lockTransmitter(irq);
+
+	uint8_t data;
+	while (ByteFifo_pull(&Stubs_txFifo, &data))
+		writeByteSync(data);
+
+	unlockTransmitter(irq);
+	waitForTransmitterIdle();
+}
+
+uint32_t
+Stubs_getDroppedByteCount(void)
+{
+	return Stubs_droppedByteCount;
+}
+
+#elif defined(USE_UART_IO) || defined(USE_USB_USART_IO)
+
+static inline void
+startBuffering(void)
+{
+}
+
+static inline void
+stopBuffering(void)
+{
+}
+
+static inline void
+writeByte(const uint8_t data)
+{
+	writeByteSync(data);
+}
+
+static inline void
+waitForTransmitterReady(void)
+{
+	waitForTransmitterIdle();
+}
+
+void
+Stubs_flush(void)
+{
+	waitForTransmitterIdle();
+}
+
+uint32_t
+Stubs_getDroppedByteCount(void)
+{
+	return 0;
+}
+
+#else
+
+void
+Stubs_flush(void)
+{
+	waitForTransmitterReady();
+}
+
+#endif
+
+#if defined(USE_UART_IO) || defined(USE_USB_USART_IO)
+static inline void
+writeBytes(const uint8_t *const data, const uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i++)
+		writeByte(data[i]);
+}
+#endif
+
 int _fstat(const int file, struct stat *const st);
 int
 _fstat(const int file, struct stat *const st)
@@ -516,12 +867,10 @@ _write(const int fd, const void *const buffer, const unsigned int count)
 {
 	const uint8_t *data = (const uint8_t *)buffer;
 
-	for (uint32_t i = 0; i < count; i++) {
-		if (fd == GCOV_DUMMY_FD)
-			writeByteAsHexString(data[i]);
-		else
-			writeByte(data[i]);
-	}
+	if (fd == GCOV_DUMMY_FD)
+		CoverageTransport_write(&Stubs_coverageTransport, data, count);
+	else
+		writeBytes(data, count);
 
 	waitForTransmitterReady();
 
@@ -536,6 +885,7 @@ _open(const char *const filename, const int oflag)
 	WRITE_STRING_CONSTANT("\n>>>");
 	_write(1, filename, strlen(filename));
 	WRITE_STRING_CONSTANT("\n");
+	CoverageTransport_begin(&Stubs_coverageTransport, writeByte);
 	return GCOV_DUMMY_FD;
 }
 
@@ -551,7 +901,10 @@ int _close(const int file);
 int
 _close(const int file)
 {
-	(void)file;
+	if (file == GCOV_DUMMY_FD) {
+		CoverageTransport_end(&Stubs_coverageTransport);
+		waitForTransmitterReady();
+	}
 	return 0;
 }
 
@@ -589,6 +942,8 @@ _exit(const int status)
 	WRITE_STRING_CONSTANT("\n>> COVERAGE RESULT - END <<\n");
 #endif
 
+	Stubs_flush();
+
 	asm volatile("BKPT #0");
 	for (;;)
 		;
@@ -34,6 +34,28 @@
 #define LOW_LEVEL_IO_BAUDRATE 115200
 #endif
 
+/// \brief Buffered IO overflow policy: the writer sends the oldest buffered
+/// bytes synchronously until there is room.
+#define LOW_LEVEL_IO_OVERFLOW_BLOCK 0
+/// \brief Buffered IO overflow policy: new bytes are dropped.
+#define LOW_LEVEL_IO_OVERFLOW_DROP 1
+/// \brief Buffered IO overflow policy: the oldest buffered bytes are dropped.
+#define LOW_LEVEL_IO_OVERFLOW_OVERWRITE 2
+
+#ifndef LOW_LEVEL_IO_OVERFLOW_POLICY
+/// \brief Default buffered IO overflow policy if not specified
+#define LOW_LEVEL_IO_OVERFLOW_POLICY LOW_LEVEL_IO_OVERFLOW_BLOCK
+#endif
+
+/// \brief Magic value of the SDRAM stdout ring header ("SLOG"). The ring is
+/// used instead of a linear buffer when LOW_LEVEL_IO_SDRAM_RING is defined.
+#define LOW_LEVEL_IO_SDRAM_RING_MAGIC 0x474F4C53u
+
+#ifndef LOW_LEVEL_IO_BUFFER_SIZE
+/// \brief Default buffered IO queue size if not specified
+#define LOW_LEVEL_IO_BUFFER_SIZE 1024
+#endif
+
 /// \brief Performs a hardware setup procedure of Stubs module.
 void Stubs_startup(void);
 
@@ -44,4 +66,16 @@ void Stubs_shutdown(void);
 /// \param byte Byte to be written.
 void Stubs_writeByte(uint8_t byte);
 
+/// \brief Sends out all buffered output and waits until the transmitter is
+/// idle. When USE_BUFFERED_IO is defined, output is queued and sent from the
+/// UART/USART interrupt, otherwise it is written synchronously.
+void Stubs_flush(void);
+
+/// \brief Returns the number of output bytes dropped by the buffered IO
+/// overflow policy. When USE_SDRAM_IO is defined without
+/// LOW_LEVEL_IO_SDRAM_RING, returns the number of output bytes truncated
+/// because the SDRAM output area is full.
+/// \returns Dropped byte count.
+uint32_t Stubs_getDroppedByteCount(void);
+
 #endif // STUBS_H
@@ -35,6 +35,10 @@ enum { SystemConfig_DefaultCoreClock = 150000000 };
 /// \brief Default peripheral clock (MCK) frequency in [Hz].
 enum { SystemConfig_DefaultPeriphClock = 75000000 };
 
+/// \brief Index of the programmable clock feeding the UART/USART baud rate
+/// generators.
+enum { SystemConfig_UartPckIndex = 4 };
+
 /// \brief Base address of the embedded flash.
 enum { SystemConfig_FlashBaseAddress = 0x00400000u };
 
@@ -70,9 +74,9 @@ SystemConfig_getPmcDefaultConfig(void)
 	config.pckConfig[0].pckPresc = 30;
 
 	// The UART/USART PCK shall be 3 times slower that peripheral clock.
-	config.pckConfig[4].isEnabled = true;
-	config.pckConfig[4].pckSrc = Pmc_PckSrc_Pllack;
-	config.pckConfig[4].pckPresc = 12;
+	config.pckConfig[SystemConfig_UartPckIndex].isEnabled = true;
+	config.pckConfig[SystemConfig_UartPckIndex].pckSrc = Pmc_PckSrc_Pllack;
+	config.pckConfig[SystemConfig_UartPckIndex].pckPresc = 12;
 
 	// The CAN clock speed should not exceed the peripheral clock.
 	config.pckConfig[5].isEnabled = true;
@@ -0,0 +1,80 @@
+/**@file
+ * This file is part of the ARM BSP for the Test Environment.
+ *
+ * @copyright 2020-2021 N7 Space Sp. z o.o.
+ *
+ * Test Environment was developed under a programme of,
+ * and funded by, the European Space Agency (the "ESA").
+ *
+ *
+ * Licensed under the ESA Public License (ESA-PL) Permissive,
+ * Version 2.3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://essr.esa.int/license/list
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Trace.h"
+
+#include <string.h>
+
+#include <Stubs/Stubs.h>
+
+Trace_Ring Trace_ring;
+
+void
+Trace_init(void)
+{
+	memset(&Trace_ring, 0, sizeof(Trace_Ring));
+
+	if (!Dwt_isCycleCounterEnabled())
+		Dwt_enableCycleCounter();
+}
+
+static inline void
+writeWord(const uint32_t word)
+{
+	// Little-endian, matching the target byte order.
+	Stubs_writeByte((uint8_t)(word & 0xFFu));
+	Stubs_writeByte((uint8_t)((word >> 8u) & 0xFFu));
+	Stubs_writeByte((uint8_t)((word >> 16u) & 0xFFu));
+	Stubs_writeByte((uint8_t)((word >> 24u) & 0xFFu));
+}
+
+uint32_t
+Trace_flush(void)
+{
+	uint32_t count = 0;
+	uint32_t tail = Trace_ring.tail;
+
+	while (tail != Trace_ring.head) {
+		const uint32_t header = Trace_ring.buffer[tail & TRACE_BUFFER_MASK];
+		const uint32_t recordWords = TRACE_RECORD_HEADER_WORDS
+				+ (header & TRACE_HEADER_ARG_COUNT_MASK);
+
+		Stubs_writeByte(TRACE_RECORD_SYNC_BYTE);
+		for (uint32_t i = 0; i < recordWords; i++)
+			writeWord(Trace_ring.buffer[(tail + i)
+					& TRACE_BUFFER_MASK]);
+
+		tail += recordWords;
+		// Publish the freed space only after the record was read out.
+		Trace_ring.tail = tail;
+		count++;
+	}
+
+	return count;
+}
+
+uint32_t
+Trace_getDroppedRecordCount(void)
+{
+	return Trace_ring.droppedRecords;
+}
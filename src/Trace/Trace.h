@@ -0,0 +1,190 @@
+/**@file
+ * This file is part of the ARM BSP for the Test Environment.
+ *
+ * @copyright 2020-2021 N7 Space Sp. z o.o.
+ *
+ * Test Environment was developed under a programme of,
+ * and funded by, the European Space Agency (the "ESA").
+ *
+ *
+ * Licensed under the ESA Public License (ESA-PL) Permissive,
+ * Version 2.3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://essr.esa.int/license/list
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/// \brief Deferred-format binary trace logger. Call sites store a format string
+/// identifier and raw 32-bit arguments in a ring buffer; the records are sent
+/// over the low-level IO selected in Stubs and formatted offline by
+/// tools/trace_decode.py.
+
+/**
+ * @defgroup Trace Trace
+ * @ingroup Bsp
+ * @{
+ */
+
+#ifndef BSP_TRACE_H
+#define BSP_TRACE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <Dwt/Dwt.h>
+
+#ifndef TRACE_BUFFER_WORDS
+/// \brief Default trace ring size in 32-bit words, shall be a power of 2.
+#define TRACE_BUFFER_WORDS 1024u
+#endif
+
+/// \brief Mask used to wrap trace ring indices.
+#define TRACE_BUFFER_MASK (TRACE_BUFFER_WORDS - 1u)
+
+/// \brief Number of words preceding the arguments in a record (header and
+/// timestamp).
+#define TRACE_RECORD_HEADER_WORDS 2u
+
+/// \brief Number of header bits holding the argument count.
+#define TRACE_HEADER_ARG_COUNT_BITS 3u
+/// \brief Header argument count mask.
+#define TRACE_HEADER_ARG_COUNT_MASK 0x00000007u
+
+/// \brief Byte preceding every record sent over the low-level IO, so that the
+/// decoder can resynchronize and pass through interleaved text.
+#define TRACE_RECORD_SYNC_BYTE 0x1Eu
+
+/// \brief Name of the section holding format strings. The section is not
+/// loaded, so the address of a string in it is its offset, used as the ID.
+#define TRACE_FORMAT_SECTION ".traceFormats"
+
+/// \brief Trace ring buffer.
+typedef struct {
+	uint32_t buffer[TRACE_BUFFER_WORDS]; ///< Record storage.
+	volatile uint32_t head; ///< Free-running write index.
+	volatile uint32_t tail; ///< Free-running read index.
+	volatile uint32_t droppedRecords; ///< Records dropped on a full ring.
+} Trace_Ring;
+
+/// \brief The trace ring shared by all call sites.
+extern Trace_Ring Trace_ring;
+
+/// \brief Disables interrupts, returning the previous PRIMASK value.
+/// \returns PRIMASK value to be restored.
+static inline uint32_t
+Trace_lock(void)
+{
+	uint32_t primask;
+	asm volatile("mrs %0, primask\n"
+		     "cpsid i\n"
+			: "=r"(primask)
+			:
+			: "memory");
+	return primask;
+}
+
+/// \brief Restores PRIMASK saved by Trace_lock.
+/// \param [in] primask PRIMASK value returned by Trace_lock.
+static inline void
+Trace_unlock(const uint32_t primask)
+{
+	asm volatile("msr primask, %0\n" : : "r"(primask) : "memory");
+}
+
+/// \brief Stores a trace record in the ring. Use the TRACE_LOGn macros instead
+///        of calling this function directly.
+/// \param [in] formatId Format string identifier.
+/// \param [in] argCount Number of arguments (at most 4).
+/// \param [in] args Arguments.
+static inline void
+Trace_record(const uint32_t formatId, const uint32_t argCount,
+		const uint32_t *const args)
+{
+	const uint32_t primask = Trace_lock();
+
+	const uint32_t head = Trace_ring.head;
+	const uint32_t recordWords = TRACE_RECORD_HEADER_WORDS + argCount;
+	if (((head - Trace_ring.tail) + recordWords) > TRACE_BUFFER_WORDS) {
+		Trace_ring.droppedRecords++;
+		Trace_unlock(primask);
+		return;
+	}
+
+	Trace_ring.buffer[head & TRACE_BUFFER_MASK] =
+			(formatId << TRACE_HEADER_ARG_COUNT_BITS) | argCount;
+	Trace_ring.buffer[(head + 1u) & TRACE_BUFFER_MASK] = Dwt_getCycleCount();
+	for (uint32_t i = 0; i < argCount; i++)
+		Trace_ring.buffer[(head + TRACE_RECORD_HEADER_WORDS + i)
+				& TRACE_BUFFER_MASK] = args[i];
+	Trace_ring.head = head + recordWords;
+
+	Trace_unlock(primask);
+}
+
+// clang-format off
+/// \brief Defines a format string in the format section and evaluates to its
+///        identifier.
+#define TRACE_FORMAT_ID(FORMAT)                                               \
+  ({ static const char traceFormat[]                                          \
+         __attribute__((section(TRACE_FORMAT_SECTION), used)) = FORMAT;       \
+     (uint32_t)(uintptr_t)traceFormat; })
+
+/// \brief Logs a message without arguments.
+#define TRACE_LOG0(FORMAT)                                                    \
+  Trace_record(TRACE_FORMAT_ID(FORMAT), 0u, NULL)
+
+/// \brief Logs a message with one 32-bit argument.
+#define TRACE_LOG1(FORMAT, A0)                                                \
+  do {                                                                        \
+    const uint32_t traceArgs[] = { (uint32_t)(A0) };                          \
+    Trace_record(TRACE_FORMAT_ID(FORMAT), 1u, traceArgs);                     \
+  } while (0)
+
+/// \brief Logs a message with two 32-bit arguments.
+#define TRACE_LOG2(FORMAT, A0, A1)                                            \
+  do {                                                                        \
+    const uint32_t traceArgs[] = { (uint32_t)(A0), (uint32_t)(A1) };          \
+    Trace_record(TRACE_FORMAT_ID(FORMAT), 2u, traceArgs);                     \
+  } while (0)
+
+/// \brief Logs a message with three 32-bit arguments.
+#define TRACE_LOG3(FORMAT, A0, A1, A2)                                        \
+  do {                                                                        \
+    const uint32_t traceArgs[] = { (uint32_t)(A0), (uint32_t)(A1),            \
+                                   (uint32_t)(A2) };                          \
+    Trace_record(TRACE_FORMAT_ID(FORMAT), 3u, traceArgs);                     \
+  } while (0)
+
+/// \brief Logs a message with four 32-bit arguments.
+#define TRACE_LOG4(FORMAT, A0, A1, A2, A3)                                    \
+  do {                                                                        \
+    const uint32_t traceArgs[] = { (uint32_t)(A0), (uint32_t)(A1),            \
+                                   (uint32_t)(A2), (uint32_t)(A3) };          \
+    Trace_record(TRACE_FORMAT_ID(FORMAT), 4u, traceArgs);                     \
+  } while (0)
+// clang-format on
+
+/// \brief Clears the trace ring and starts the DWT cycle counter used for
+///        record timestamps.
+void Trace_init(void);
+
+/// \brief Sends all pending records over the low-level IO selected in Stubs.
+///        Shall be called from a single context, e.g. the idle loop.
+/// \returns The number of sent records.
+uint32_t Trace_flush(void);
+
+/// \brief Returns the number of records dropped because the ring was full.
+/// \returns Dropped record count.
+uint32_t Trace_getDroppedRecordCount(void);
+
+#endif // BSP_TRACE_H
+
+/** @} */
@@ -26,7 +26,10 @@
 #include <assert.h>
 #include <string.h>
 
+#include <Dwt/Dwt.h>
+
 #define UART_BAUDRATE_BASE_SCALER 16u
+#define UART_BAUDRATE_ERROR_SCALE 1000000
 
 static inline void
 enableTxIrq(Uart *const uart)
@@ -93,6 +96,111 @@ Uart_init(const Uart_Id id, Uart *const uart)
 	uart->reg = (Uart_Registers *)registersAddress;
 }
 
+static uint32_t
+calculateClockDivisor(const uint32_t clkFreq, const uint32_t baudRate)
+{
+	// Round to the nearest divisor instead of truncating, which halves the
+	// worst-case baud rate error.
+	const uint64_t scaledBaudRate =
+			(uint64_t)UART_BAUDRATE_BASE_SCALER * baudRate;
+	return (uint32_t)(((uint64_t)clkFreq + (scaledBaudRate / 2u))
+			/ scaledBaudRate);
+}
+
+static void
+fillBaudRateInfo(const uint32_t baudRate, const uint32_t divisor,
+		Uart_BaudRateInfo *const info)
+{
+	info->clockDivisor = (uint16_t)divisor;
+	info->achievedBaudRate = info->baudRateClkFreq
+			/ (UART_BAUDRATE_BASE_SCALER * divisor);
+	const int64_t error = ((int64_t)info->baudRateClkFreq
+					      * UART_BAUDRATE_ERROR_SCALE)
+					/ ((int64_t)UART_BAUDRATE_BASE_SCALER
+							* divisor)
+			- ((int64_t)baudRate * UART_BAUDRATE_ERROR_SCALE);
+	info->errorPpm = (int32_t)(error / (int64_t)baudRate);
+}
+
+bool
+Uart_calculateBaudRate(const uint32_t baudRate, const Uart_BaudRateClk clkSrc,
+		const uint32_t clkFreq, Uart_BaudRateInfo *const info,
+		int *const errCode)
+{
+	if (baudRate == 0u)
+		return returnError(errCode, Uart_ErrorCodes_BaudRateOutOfRange);
+
+	const uint32_t divisor = calculateClockDivisor(clkFreq, baudRate);
+	if ((divisor == 0u) || (divisor > UART_BRGR_CD_MASK))
+		return returnError(errCode, Uart_ErrorCodes_BaudRateOutOfRange);
+
+	info->baudRateClkSrc = clkSrc;
+	info->baudRateClkFreq = clkFreq;
+	fillBaudRateInfo(baudRate, divisor, info);
+
+	return true;
+}
+
+static inline uint32_t
+absoluteError(const int32_t errorPpm)
+{
+	return (errorPpm < 0) ? (uint32_t)(-errorPpm) : (uint32_t)errorPpm;
+}
+
+bool
+Uart_selectBaudRateClk(Uart_Config *const config,
+		const uint32_t peripheralClkFreq, const uint32_t pckFreq,
+		Uart_BaudRateInfo *const info, int *const errCode)
+{
+	Uart_BaudRateInfo peripheralClkInfo;
+	Uart_BaudRateInfo pckInfo;
+
+	const bool isPeripheralClkValid = Uart_calculateBaudRate(
+			config->baudRate, Uart_BaudRateClk_PeripheralCk,
+			peripheralClkFreq, &peripheralClkInfo, errCode);
+	const bool isPckValid = (pckFreq != 0u)
+			&& Uart_calculateBaudRate(config->baudRate,
+					Uart_BaudRateClk_Pck, pckFreq, &pckInfo,
+					errCode);
+
+	if (!isPeripheralClkValid && !isPckValid)
+		return returnError(errCode, Uart_ErrorCodes_BaudRateOutOfRange);
+
+	// Prefer the peripheral clock when both sources are equally accurate,
+	// as it does not depend on the PCK configuration.
+	if (isPckValid
+			&& (!isPeripheralClkValid
+					|| (absoluteError(pckInfo.errorPpm)
+							< absoluteError(peripheralClkInfo
+											.errorPpm))))
+		*info = pckInfo;
+	else
+		*info = peripheralClkInfo;
+
+	config->baudRateClkSrc = info->baudRateClkSrc;
+	config->baudRateClkFreq = info->baudRateClkFreq;
+
+	return true;
+}
+
+void
+Uart_getBaudRateInfo(const Uart *const uart, Uart_BaudRateInfo *const info)
+{
+	info->baudRateClkSrc = uart->config.baudRateClkSrc;
+	info->baudRateClkFreq = uart->config.baudRateClkFreq;
+
+	const uint32_t divisor = (uart->reg->brgr & UART_BRGR_CD_MASK)
+			>> UART_BRGR_CD_OFFSET;
+	if ((divisor == 0u) || (uart->config.baudRate == 0u)) {
+		info->clockDivisor = 0;
+		info->achievedBaudRate = 0;
+		info->errorPpm = 0;
+		return;
+	}
+
+	fillBaudRateInfo(uart->config.baudRate, divisor, info);
+}
+
 void
 Uart_setConfig(Uart *const uart, const Uart_Config *const config)
 {
@@ -118,8 +226,11 @@ Uart_setConfig(Uart *const uart, const Uart_Config *const config)
 
 	uart->reg->mr = mr;
 
-	uart->reg->brgr = (config->baudRateClkFreq
-			/ (UART_BAUDRATE_BASE_SCALER * config->baudRate));
+	const uint32_t divisor = calculateClockDivisor(
+			config->baudRateClkFreq, config->baudRate);
+	assert((divisor > 0u) && (divisor <= UART_BRGR_CD_MASK));
+
+	uart->reg->brgr = (divisor << UART_BRGR_CD_OFFSET) & UART_BRGR_CD_MASK;
 
 	uart->config = *config;
 }
@@ -156,6 +267,9 @@ Uart_write(Uart *const uart, const uint8_t data, uint32_t const timeoutLimit,
 
 	uart->reg->thr = data;
 
+	if (uart->isStatisticsEnabled)
+		uart->statistics.txBytes++;
+
 	return true;
 }
 
@@ -172,6 +286,9 @@ Uart_read(Uart *const uart, uint8_t *const data, uint32_t timeoutLimit,
 
 	*data = (uint8_t)uart->reg->rhr;
 
+	if (uart->isStatisticsEnabled)
+		uart->statistics.rxBytes++;
+
 	return true;
 }
 
@@ -187,6 +304,8 @@ Uart_writeAsync(Uart *const uart, ByteFifo *const fifo,
 	uint8_t data;
 	if ((uart->txFifo != NULL) && ByteFifo_pull(uart->txFifo, &data)) {
 		uart->reg->thr = data;
+		if (uart->isStatisticsEnabled)
+			uart->statistics.txBytes++;
 		enableTxIrq(uart);
 	}
 }
@@ -273,6 +392,9 @@ handleRxInterrupt(Uart *const uart, int* const errCode)
 {
 	uint8_t data = (uint8_t)uart->reg->rhr;
 
+	if (uart->isStatisticsEnabled)
+		uart->statistics.rxBytes++;
+
 	if (uart->rxFifo == NULL) {
 		disableRxIrq(uart);
 		return true;
@@ -293,14 +415,17 @@ handleRxInterrupt(Uart *const uart, int* const errCode)
 	return true;
 }
 
-static inline void
+static inline bool
 handleTxInterrupt(Uart *const uart)
 {
 	uint8_t data = 0;
 	if (uart->txFifo == NULL) {
 		disableTxIrq(uart);
+		return false;
 	} else if (ByteFifo_pull(uart->txFifo, &data)) {
 		uart->reg->thr = data;
+		if (uart->isStatisticsEnabled)
+			uart->statistics.txBytes++;
 	} else {
 		do {
 			if (uart->txHandler.callback != NULL)
@@ -311,12 +436,15 @@ handleTxInterrupt(Uart *const uart)
 
 			if (uart->txFifo == NULL) {
 				disableTxIrq(uart);
-				return;
+				return false;
 			}
 		} while (!ByteFifo_pull(uart->txFifo, &data));
 
 		uart->reg->thr = data;
+		if (uart->isStatisticsEnabled)
+			uart->statistics.txBytes++;
 	}
+	return true;
 }
 
 static inline bool
@@ -326,29 +454,126 @@ Uart_hasAnyErrorOccured(Uart_ErrorFlags* const errFlags)
             || errFlags->hasRxFifoFullErrorOccurred);
 }
 
-void
-Uart_handleInterrupt(Uart *const uart)
+static inline void
+updateErrorStatistics(Uart *const uart, const uint32_t status,
+		const int errorCode)
 {
-	int errorCode = 0;
+	if ((status & UART_SR_OVRE_MASK) != 0u)
+		uart->statistics.overrunErrors++;
+	if ((status & UART_SR_FRAME_MASK) != 0u)
+		uart->statistics.framingErrors++;
+	if ((status & UART_SR_PARE_MASK) != 0u)
+		uart->statistics.parityErrors++;
+	if (errorCode == Uart_ErrorCodes_Rx_Fifo_Full)
+		uart->statistics.rxFifoFullDrops++;
+}
+
+static void
+handleErrors(Uart *const uart, const uint32_t sr, const uint32_t status,
+		const int errorCode)
+{
+	if (uart->isStatisticsEnabled)
+		updateErrorStatistics(uart, sr, errorCode);
+
+	if (uart->errorHandler.callback == NULL)
+		return;
+
 	Uart_ErrorFlags errorFlags = { false, false, false, false };
+	if (errorCode == Uart_ErrorCodes_Rx_Fifo_Full)
+		errorFlags.hasRxFifoFullErrorOccurred = true;
+	Uart_getLinkErrors(status, &errorFlags);
+	if(Uart_hasAnyErrorOccured(&errorFlags))
+   		uart->errorHandler.callback(errorFlags, uart->errorHandler.arg);
+}
 
-	uint32_t status = uart->reg->sr & uart->reg->imr;
+static void
+handleInterrupt(Uart *const uart, const uint32_t sr)
+{
+	int errorCode = 0;
+
+	uint32_t status = sr & uart->reg->imr;
 	uart->reg->cr = UART_CR_RSTSTA_MASK;
 	if ((status & UART_SR_RXRDY_MASK) != 0u)
-	{
 		handleRxInterrupt(uart, &errorCode);
-		if(errorCode  == Uart_ErrorCodes_Rx_Fifo_Full)
-			errorFlags.hasRxFifoFullErrorOccurred = true;
-	}
 	if ((status & UART_SR_TXEMPTY_MASK) != 0u)
-		handleTxInterrupt(uart);
+		(void)handleTxInterrupt(uart);
 
-	if (uart->errorHandler.callback == NULL)
+	handleErrors(uart, sr, status, errorCode);
+}
+
+void
+Uart_handleInterrupt(Uart *const uart)
+{
+	// The raw status is used for statistics, so that errors are counted
+	// even if the error interrupts are not enabled.
+	const uint32_t sr = uart->reg->sr;
+
+	if (!uart->isStatisticsEnabled) {
+		handleInterrupt(uart, sr);
 		return;
+	}
 
-	Uart_getLinkErrors(status, &errorFlags);
-	if(Uart_hasAnyErrorOccured(&errorFlags))
-   		uart->errorHandler.callback(errorFlags, uart->errorHandler.arg);
+	const uint32_t startCycles = Dwt_getCycleCount();
+	handleInterrupt(uart, sr);
+	uart->statistics.interrupts++;
+	uart->statistics.interruptCycles += Dwt_getCycleCount() - startCycles;
+}
+
+uint32_t
+Uart_service(Uart *const uart)
+{
+	int errorCode = 0;
+	uint32_t count = 0;
+
+	const uint32_t sr = uart->reg->sr;
+	if ((sr & (UART_SR_OVRE_MASK | UART_SR_FRAME_MASK | UART_SR_PARE_MASK))
+			!= 0u)
+		uart->reg->cr = UART_CR_RSTSTA_MASK;
+
+	if (((sr & UART_SR_RXRDY_MASK) != 0u) && (uart->rxFifo != NULL)) {
+		handleRxInterrupt(uart, &errorCode);
+		count++;
+	}
+	if (((sr & UART_SR_TXRDY_MASK) != 0u) && (uart->txFifo != NULL)
+			&& handleTxInterrupt(uart))
+		count++;
+
+	handleErrors(uart, sr, sr, errorCode);
+
+	return count;
+}
+
+void
+Uart_setStatisticsEnabled(Uart *const uart, const bool isEnabled)
+{
+	if (isEnabled && !Dwt_isCycleCounterEnabled())
+		Dwt_enableCycleCounter();
+
+	uart->isStatisticsEnabled = isEnabled;
+}
+
+void
+Uart_getStatistics(Uart *const uart, Uart_Statistics *const statistics)
+{
+	// Mask the device interrupts, so that the snapshot is not torn by
+	// Uart_handleInterrupt.
+	const uint32_t imr = uart->reg->imr;
+	uart->reg->idr = imr;
+
+	*statistics = uart->statistics;
+
+	uart->reg->ier = imr;
+}
+
+void
+Uart_resetStatistics(Uart *const uart)
+{
+	const uint32_t imr = uart->reg->imr;
+	uart->reg->idr = imr;
+
+	memset(&uart->statistics, 0, sizeof(Uart_Statistics));
+
+	uart->reg->ier = imr;
 }
 
 inline bool
@@ -72,6 +72,16 @@ typedef struct {
 	uint32_t baudRateClkFreq; ///< Baud rate clock source frequency.
 } Uart_Config;
 
+/// \brief Uart baud rate generator settings and the resulting accuracy.
+typedef struct {
+	Uart_BaudRateClk
+			baudRateClkSrc; ///< Indicator of the baud rate clock source.
+	uint32_t baudRateClkFreq; ///< Baud rate clock source frequency.
+	uint16_t clockDivisor; ///< Baud rate generator clock divisor (CD).
+	uint32_t achievedBaudRate; ///< Baud rate resulting from the divisor.
+	int32_t errorPpm; ///< Baud rate error relative to the target in ppm.
+} Uart_BaudRateInfo;
+
 /// \brief A function serving as a callback called at the end of transmission.
 /// \returns ByteFifo from which data transmission should be continued.
 typedef ByteFifo *(*UartTxEndCallback)(void *arg);
@@ -133,8 +143,25 @@ typedef enum
 {
     Uart_ErrorCodes_Timeout = 1,      ///< Timeout has occurred during a write/read operation.
     Uart_ErrorCodes_Rx_Fifo_Full = 2, ///< Rx fifo was full during new byte reception
+    Uart_ErrorCodes_BaudRateOutOfRange = 3, ///< Baud rate cannot be generated from the given clock.
 } Uart_ErrorCodes;
 
+/// \brief Uart runtime statistics.
+typedef struct {
+	uint32_t txBytes; ///< Number of bytes written to the transmitter.
+	uint32_t rxBytes; ///< Number of bytes read from the receiver.
+	uint32_t interrupts; ///< Number of Uart_handleInterrupt calls.
+	uint32_t overrunErrors; ///< Number of detected overrun errors.
+	uint32_t framingErrors; ///< Number of detected framing errors.
+	uint32_t parityErrors; ///< Number of detected parity errors.
+	/// \brief Number of received bytes dropped because the reception queue
+	/// was full.
+	uint32_t rxFifoFullDrops;
+	/// \brief Processor cycles spent in Uart_handleInterrupt, measured with
+	/// the DWT cycle counter.
+	uint64_t interruptCycles;
+} Uart_Statistics;
+
 /// \brief Uart device descriptor.
 typedef struct {
 	Uart_Id id; ///< Device identifier.
@@ -146,6 +173,8 @@ typedef struct {
 	volatile Uart_Registers
 			*reg; ///< Pointer to memory-mapped device registers.
 	Uart_Config config; ///< Configuration descriptor.
+	bool isStatisticsEnabled; ///< Flag indicating whether to gather statistics.
+	Uart_Statistics statistics; ///< Runtime statistics.
 } Uart;
 
 /// \brief Performs a hardware startup procedure of an Uart device.
@@ -166,6 +195,40 @@ void Uart_init(const Uart_Id id, Uart *const uart);
 /// \param [in] config A configuration descriptor.
 void Uart_setConfig(Uart *const uart, const Uart_Config *const config);
 
+/// \brief Calculates the baud rate generator settings closest to the target
+///        baud rate for the given clock source.
+/// \param [in] baudRate Target baud rate.
+/// \param [in] clkSrc Baud rate clock source.
+/// \param [in] clkFreq Baud rate clock source frequency.
+/// \param [out] info Calculated baud rate generator settings.
+/// \param [out] errCode An error code generated during the operation.
+/// \retval true The baud rate can be generated from the given clock.
+/// \retval false The required divisor is out of the supported range.
+bool Uart_calculateBaudRate(const uint32_t baudRate,
+		const Uart_BaudRateClk clkSrc, const uint32_t clkFreq,
+		Uart_BaudRateInfo *const info, int *const errCode);
+
+/// \brief Selects the baud rate clock source (peripheral clock or PCK) giving
+///        the lowest baud rate error and stores it in the configuration.
+/// \param [in,out] config A configuration descriptor with the target baud
+///                 rate set.
+/// \param [in] peripheralClkFreq Peripheral clock frequency.
+/// \param [in] pckFreq PCK frequency, 0 if PCK is not available.
+/// \param [out] info Baud rate generator settings of the selected source.
+/// \param [out] errCode An error code generated during the operation.
+/// \retval true A clock source able to generate the baud rate was selected.
+/// \retval false None of the clock sources can generate the baud rate.
+bool Uart_selectBaudRateClk(Uart_Config *const config,
+		const uint32_t peripheralClkFreq, const uint32_t pckFreq,
+		Uart_BaudRateInfo *const info, int *const errCode);
+
+/// \brief Retrieves the baud rate generator settings of an Uart device,
+///        including the achieved baud rate and its error.
+/// \param [in] uart Uart device descriptor.
+/// \param [out] info Baud rate generator settings.
+void Uart_getBaudRateInfo(
+		const Uart *const uart, Uart_BaudRateInfo *const info);
+
 /// \brief Retrieves configuration of an Uart device.
 /// \param [in] uart Uart device descriptor.
 /// \param [out] config A configuration descriptor.
@@ -239,6 +302,29 @@ uint32_t Uart_getRxFifoCount(Uart *const uart);
 void Uart_registerErrorHandler(
 		Uart *const uart, const Uart_ErrorHandler handler);
 
+/// \brief Services an Uart device without relying on interrupts: moves a
+///        received byte into the reception queue and refills the transmitter
+///        holding register from the transmission queue, calling the same
+///        handlers as Uart_handleInterrupt.
+/// \param [in] uart Uart device descriptor.
+/// \returns The number of bytes moved.
+uint32_t Uart_service(Uart *const uart);
+
+/// \brief Enables or disables gathering of runtime statistics. Enabling the
+///        statistics also starts the DWT cycle counter.
+/// \param [in] uart Uart device descriptor.
+/// \param [in] isEnabled Whether statistics should be gathered.
+void Uart_setStatisticsEnabled(Uart *const uart, const bool isEnabled);
+
+/// \brief Retrieves a consistent snapshot of the runtime statistics.
+/// \param [in] uart Uart device descriptor.
+/// \param [out] statistics Statistics snapshot.
+void Uart_getStatistics(Uart *const uart, Uart_Statistics *const statistics);
+
+/// \brief Zeroes the runtime statistics.
+/// \param [in] uart Uart device descriptor.
+void Uart_resetStatistics(Uart *const uart);
+
 /// \brief Default interrupt handler for Uart devices.
 /// \param [in] uart Uart device descriptor.
 void Uart_handleInterrupt(Uart* const uart);
@@ -0,0 +1,157 @@
+/**@file
+ * This file is part of the ARM BSP for the Test Environment.
+ *
+ * @copyright 2020-2021 N7 Space Sp. z o.o.
+ *
+ * Test Environment was developed under a programme of,
+ * and funded by, the European Space Agency (the "ESA").
+ *
+ *
+ * Licensed under the ESA Public License (ESA-PL) Permissive,
+ * Version 2.3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://essr.esa.int/license/list
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "UartService.h"
+
+#include <assert.h>
+#include <string.h>
+
+#include <Dwt/Dwt.h>
+
+#define UART_SERVICE_IRQ_MASK (UART_IDR_RXRDY_MASK | UART_IDR_TXEMPTY_MASK)
+
+static void
+applyMode(Uart *const uart, const UartService_Mode mode)
+{
+	if (mode == UartService_Mode_Polled) {
+		uart->reg->idr = UART_SERVICE_IRQ_MASK;
+		return;
+	}
+
+	// Restore the interrupts masked while the port was polled, so that
+	// transfers in progress are serviced again.
+	uint32_t irqs = 0;
+	if (uart->rxFifo != NULL)
+		irqs |= UART_IER_RXRDY_MASK;
+	if (uart->txFifo != NULL)
+		irqs |= UART_IER_TXEMPTY_MASK;
+	uart->reg->ier = irqs;
+}
+
+void
+UartService_init(UartService *const service)
+{
+	memset(service, 0, sizeof(UartService));
+	service->statistics.minPassCycles = UINT32_MAX;
+
+	if (!Dwt_isCycleCounterEnabled())
+		Dwt_enableCycleCounter();
+}
+
+bool
+UartService_addPort(UartService *const service, Uart *const uart,
+		const UartService_Mode mode, int *const errCode)
+{
+	if (service->portCount >= UART_SERVICE_MAX_PORTS)
+		return returnError(errCode, UartService_ErrorCodes_TooManyPorts);
+
+	service->ports[service->portCount].uart = uart;
+	service->ports[service->portCount].mode = mode;
+	service->portCount++;
+
+	applyMode(uart, mode);
+
+	return true;
+}
+
+void
+UartService_setMode(UartService *const service, const Uart *const uart,
+		const UartService_Mode mode)
+{
+	for (uint32_t i = 0; i < service->portCount; i++) {
+		if (service->ports[i].uart != uart)
+			continue;
+
+		service->ports[i].mode = mode;
+		applyMode(service->ports[i].uart, mode);
+		return;
+	}
+	assert(0 && "Port not added to the service engine");
+}
+
+static uint32_t
+serviceHybridPort(Uart *const uart)
+{
+	// Mask the interrupts, so that the port is not serviced concurrently
+	// by Uart_handleInterrupt; TX/RX interrupts disabled by the service
+	// (e.g. at the end of transmission) are not restored.
+	const uint32_t imr = uart->reg->imr & UART_SERVICE_IRQ_MASK;
+	uart->reg->idr = imr;
+
+	const uint32_t count = Uart_service(uart);
+
+	uint32_t restoredIrqs = 0;
+	if (uart->rxFifo != NULL)
+		restoredIrqs |= imr & UART_IER_RXRDY_MASK;
+	if (uart->txFifo != NULL)
+		restoredIrqs |= imr & UART_IER_TXEMPTY_MASK;
+	uart->reg->ier = restoredIrqs;
+
+	return count;
+}
+
+static inline void
+updateStatistics(UartService_Statistics *const statistics,
+		const uint32_t cycles, const uint32_t count)
+{
+	statistics->passes++;
+	statistics->lastPassCycles = cycles;
+	statistics->lastPassBytes = count;
+	statistics->totalPassCycles += cycles;
+	if (cycles < statistics->minPassCycles)
+		statistics->minPassCycles = cycles;
+	if (cycles > statistics->maxPassCycles)
+		statistics->maxPassCycles = cycles;
+}
+
+uint32_t
+UartService_poll(UartService *const service)
+{
+	const uint32_t startCycles = Dwt_getCycleCount();
+
+	uint32_t count = 0;
+	for (uint32_t i = 0; i < service->portCount; i++) {
+		UartService_Port *const port = &service->ports[i];
+		switch (port->mode) {
+		case UartService_Mode_Interrupt: break;
+		case UartService_Mode_Polled:
+			count += Uart_service(port->uart);
+			break;
+		case UartService_Mode_Hybrid:
+			count += serviceHybridPort(port->uart);
+			break;
+		}
+	}
+
+	updateStatistics(&service->statistics,
+			Dwt_getCycleCount() - startCycles, count);
+
+	return count;
+}
+
+void
+UartService_getStatistics(const UartService *const service,
+		UartService_Statistics *const statistics)
+{
+	*statistics = service->statistics;
+}
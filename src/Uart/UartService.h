@@ -0,0 +1,124 @@
+/**@file
+ * This file is part of the ARM BSP for the Test Environment.
+ *
+ * @copyright 2020-2021 N7 Space Sp. z o.o.
+ *
+ * Test Environment was developed under a programme of,
+ * and funded by, the European Space Agency (the "ESA").
+ *
+ *
+ * Licensed under the ESA Public License (ESA-PL) Permissive,
+ * Version 2.3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://essr.esa.int/license/list
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/// \brief Uart service engine servicing several Uart devices in a single pass,
+/// allowing high-rate operation without per-byte interrupts.
+
+/**
+ * @defgroup UartService UartService
+ * @ingroup Uart
+ * @{
+ */
+
+#ifndef BSP_UART_SERVICE_H
+#define BSP_UART_SERVICE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "Uart.h"
+
+/// \brief Maximum number of ports handled by a single engine.
+#define UART_SERVICE_MAX_PORTS 5u
+
+/// \brief Port service modes.
+typedef enum {
+	/// \brief Port is serviced by Uart_handleInterrupt only and skipped by
+	/// the engine.
+	UartService_Mode_Interrupt = 0,
+	/// \brief Port is serviced by the engine only. The RX/TX interrupts of
+	/// the device are disabled and its NVIC line shall be kept disabled.
+	UartService_Mode_Polled = 1,
+	/// \brief Port keeps its interrupts and is additionally serviced by the
+	/// engine, with the RX/TX interrupts masked for the duration of the
+	/// pass.
+	UartService_Mode_Hybrid = 2,
+} UartService_Mode;
+
+/// \brief Uart service engine error codes.
+typedef enum {
+	/// \brief The maximum number of ports has already been added.
+	UartService_ErrorCodes_TooManyPorts = 1,
+} UartService_ErrorCodes;
+
+/// \brief A port handled by the service engine.
+typedef struct {
+	Uart *uart; ///< Uart device descriptor.
+	UartService_Mode mode; ///< Service mode of the port.
+} UartService_Port;
+
+/// \brief Service pass latency statistics, in processor cycles.
+typedef struct {
+	uint32_t passes; ///< Number of executed passes.
+	uint32_t lastPassCycles; ///< Duration of the last pass.
+	uint32_t minPassCycles; ///< Duration of the shortest pass.
+	uint32_t maxPassCycles; ///< Duration of the longest pass.
+	uint64_t totalPassCycles; ///< Cumulative duration of all passes.
+	uint32_t lastPassBytes; ///< Number of bytes moved in the last pass.
+} UartService_Statistics;
+
+/// \brief Uart service engine descriptor.
+typedef struct {
+	UartService_Port ports[UART_SERVICE_MAX_PORTS]; ///< Serviced ports.
+	uint32_t portCount; ///< Number of serviced ports.
+	UartService_Statistics statistics; ///< Pass latency statistics.
+} UartService;
+
+/// \brief Initializes a service engine descriptor and starts the DWT cycle
+///        counter used for latency measurement.
+/// \param [out] service Service engine descriptor.
+void UartService_init(UartService *const service);
+
+/// \brief Adds an Uart device to the serviced ports.
+/// \param [in] service Service engine descriptor.
+/// \param [in] uart Uart device descriptor.
+/// \param [in] mode Service mode of the port.
+/// \param [out] errCode An error code generated during the operation.
+/// \retval true The port was added.
+/// \retval false The maximum number of ports has been reached.
+bool UartService_addPort(UartService *const service, Uart *const uart,
+		const UartService_Mode mode, int *const errCode);
+
+/// \brief Changes the service mode of an Uart device. When leaving the polled
+///        mode, the RX/TX interrupts of transfers in progress are re-enabled.
+/// \param [in] service Service engine descriptor.
+/// \param [in] uart Uart device descriptor, previously added to the engine.
+/// \param [in] mode New service mode of the port.
+void UartService_setMode(UartService *const service, const Uart *const uart,
+		const UartService_Mode mode);
+
+/// \brief Executes a single service pass over all polled and hybrid ports,
+///        draining ready received bytes and filling ready transmitters.
+/// \param [in] service Service engine descriptor.
+/// \returns The number of bytes moved during the pass.
+uint32_t UartService_poll(UartService *const service);
+
+/// \brief Retrieves the pass latency statistics.
+/// \param [in] service Service engine descriptor.
+/// \param [out] statistics Statistics snapshot.
+void UartService_getStatistics(const UartService *const service,
+		UartService_Statistics *const statistics);
+
+#endif // BSP_UART_SERVICE_H
+
+/** @} */
@@ -0,0 +1,666 @@
+/**@file
+ * This file is part of the ARM BSP for the Test Environment.
+ *
+ * @copyright 2020-2021 N7 Space Sp. z o.o.
+ *
+ * Test Environment was developed under a programme of,
+ * and funded by, the European Space Agency (the "ESA").
+ *
+ *
+ * Licensed under the ESA Public License (ESA-PL) Permissive,
+ * Version 2.3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://essr.esa.int/license/list
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Usart.h"
+
+#include <assert.h>
+#include <string.h>
+
+#define USART_BAUDRATE_BASE_SCALER 16u
+#define USART_BAUDRATE_OVERSAMPLING_8X_SCALER 8u
+#define USART_BAUDRATE_FRACTION_SCALER 8u
+#define USART_BAUDRATE_CLK_DIV 8u
+#define USART_BAUDRATE_ERROR_SCALE 1000000
+
+static inline void
+enableTxIrq(Usart *const usart)
+{
+	usart->reg->ier = USART_IER_TXEMPTY_MASK;
+}
+
+static inline void
+disableTxIrq(Usart *const usart)
+{
+	usart->reg->idr = USART_IDR_TXEMPTY_MASK;
+}
+
+static inline void
+enableRxIrq(Usart *const usart)
+{
+	usart->reg->ier = USART_IER_RXRDY_MASK;
+}
+
+static inline void
+disableRxIrq(Usart *const usart)
+{
+	usart->reg->idr = USART_IDR_RXRDY_MASK;
+}
+
+void
+Usart_startup(Usart *const usart)
+{
+	// Disable all interrupt sources.
+	usart->reg->idr = (USART_IDR_RXRDY_MASK | USART_IDR_TXRDY_MASK
+			| USART_IDR_RXBRK_MASK | USART_IDR_OVRE_MASK
+			| USART_IDR_FRAME_MASK | USART_IDR_PARE_MASK
+			| USART_IDR_TIMEOUT_MASK | USART_IDR_TXEMPTY_MASK
+			| USART_IDR_CTSIC_MASK);
+}
+
+void
+Usart_shutdown(Usart *const usart)
+{
+	usart->reg->cr = USART_CR_RXDIS_MASK | USART_CR_TXDIS_MASK;
+}
+
+static uint32_t
+addressBase(const Usart_Id id)
+{
+	switch (id) {
+	case Usart_Id_0: return USART0_ADDRESS_BASE;
+	case Usart_Id_1: return USART1_ADDRESS_BASE;
+	case Usart_Id_2: return USART2_ADDRESS_BASE;
+	}
+	assert(0 && "Incorrect USART id");
+	return 0;
+}
+
+void
+Usart_init(const Usart_Id id, Usart *const usart)
+{
+	assert(usart != NULL);
+	memset(usart, 0, sizeof(Usart));
+
+	usart->id = id;
+
+	const uint32_t registersAddress = addressBase(id);
+	usart->reg = (Usart_Registers *)registersAddress;
+}
+
+static uint32_t
+getBaudRateGeneratorFreq(const Usart_BaudRateClk clkSrc, const uint32_t clkFreq)
+{
+	if (clkSrc == Usart_BaudRateClk_PeripheralCkDiv8)
+		return clkFreq / USART_BAUDRATE_CLK_DIV;
+	return clkFreq;
+}
+
+static uint32_t
+calculateClockDivisor(const uint32_t generatorFreq, const uint32_t baudRate,
+		const uint32_t scaler)
+{
+	// Divisor expressed in 1/8 units, so that the 3 least significant bits
+	// form the fractional part (FP) and the rest the integer part (CD).
+	const uint64_t scaledBaudRate = (uint64_t)scaler * baudRate;
+	return (uint32_t)((((uint64_t)generatorFreq
+					   * USART_BAUDRATE_FRACTION_SCALER)
+					  + (scaledBaudRate / 2u))
+			/ scaledBaudRate);
+}
+
+static void
+fillBaudRateInfo(const uint32_t baudRate, const uint32_t divisor,
+		Usart_BaudRateInfo *const info)
+{
+	const uint32_t generatorFreq = getBaudRateGeneratorFreq(
+			info->baudRateClkSrc, info->baudRateClkFreq);
+	const uint32_t scaler = info->isOversampling8x
+			? USART_BAUDRATE_OVERSAMPLING_8X_SCALER
+			: USART_BAUDRATE_BASE_SCALER;
+
+	info->clockDivisor =
+			(uint16_t)(divisor / USART_BAUDRATE_FRACTION_SCALER);
+	info->fractionalPart =
+			(uint8_t)(divisor % USART_BAUDRATE_FRACTION_SCALER);
+
+	const uint64_t scaledFreq = (uint64_t)generatorFreq
+			* USART_BAUDRATE_FRACTION_SCALER;
+	const uint64_t scaledDivisor = (uint64_t)scaler * divisor;
+	info->achievedBaudRate = (uint32_t)(scaledFreq / scaledDivisor);
+	const int64_t error = (int64_t)((scaledFreq
+						       * USART_BAUDRATE_ERROR_SCALE)
+					      / scaledDivisor)
+			- ((int64_t)baudRate * USART_BAUDRATE_ERROR_SCALE);
+	info->errorPpm = (int32_t)(error / (int64_t)baudRate);
+}
+
+static inline bool
+isClockDivisorValid(const uint32_t divisor)
+{
+	const uint32_t cd = divisor / USART_BAUDRATE_FRACTION_SCALER;
+	return (cd > 0u) && (cd <= USART_BRGR_CD_MASK);
+}
+
+bool
+Usart_calculateBaudRate(const uint32_t baudRate,
+		const Usart_BaudRateClk clkSrc, const uint32_t clkFreq,
+		Usart_BaudRateInfo *const info, int *const errCode)
+{
+	if (baudRate == 0u)
+		return returnError(
+				errCode, Usart_ErrorCodes_BaudRateOutOfRange);
+
+	const uint32_t generatorFreq =
+			getBaudRateGeneratorFreq(clkSrc, clkFreq);
+
+	// 16x oversampling is more tolerant to clock mismatch, so 8x
+	// oversampling is used only if the baud rate is otherwise too high.
+	bool isOversampling8x = false;
+	uint32_t divisor = calculateClockDivisor(
+			generatorFreq, baudRate, USART_BAUDRATE_BASE_SCALER);
+	if (!isClockDivisorValid(divisor)) {
+		isOversampling8x = true;
+		divisor = calculateClockDivisor(generatorFreq, baudRate,
+				USART_BAUDRATE_OVERSAMPLING_8X_SCALER);
+	}
+	if (!isClockDivisorValid(divisor))
+		return returnError(
+				errCode, Usart_ErrorCodes_BaudRateOutOfRange);
+
+	info->baudRateClkSrc = clkSrc;
+	info->baudRateClkFreq = clkFreq;
+	info->isOversampling8x = isOversampling8x;
+	fillBaudRateInfo(baudRate, divisor, info);
+
+	return true;
+}
+
+void
+Usart_getBaudRateInfo(const Usart *const usart, Usart_BaudRateInfo *const info)
+{
+	info->baudRateClkSrc = usart->config.baudRateClkSrc;
+	info->baudRateClkFreq = usart->config.baudRateClkFreq;
+	info->isOversampling8x = (usart->reg->mr & USART_MR_OVER_MASK) != 0u;
+
+	const uint32_t brgr = usart->reg->brgr;
+	const uint32_t divisor = (((brgr & USART_BRGR_CD_MASK)
+						  >> USART_BRGR_CD_OFFSET)
+						 * USART_BAUDRATE_FRACTION_SCALER)
+			+ ((brgr & USART_BRGR_FP_MASK) >> USART_BRGR_FP_OFFSET);
+	if (!isClockDivisorValid(divisor) || (usart->config.baudRate == 0u)) {
+		info->clockDivisor = 0;
+		info->fractionalPart = 0;
+		info->achievedBaudRate = 0;
+		info->errorPpm = 0;
+		return;
+	}
+
+	fillBaudRateInfo(usart->config.baudRate, divisor, info);
+}
+
+static uint32_t
+encodeMode(const Usart_Config *const config,
+		const Usart_BaudRateInfo *const baudRateInfo)
+{
+	const uint32_t usartMode = config->isHardwareHandshakingEnabled
+			? USART_MR_USART_MODE_HW_HANDSHAKING_VALUE
+			: USART_MR_USART_MODE_NORMAL_VALUE;
+
+	uint32_t mr = ((usartMode << USART_MR_USART_MODE_OFFSET)
+				      & USART_MR_USART_MODE_MASK)
+			| (((uint32_t)config->baudRateClkSrc
+					   << USART_MR_USCLKS_OFFSET)
+					& USART_MR_USCLKS_MASK)
+			| (((uint32_t)config->parity << USART_MR_PAR_OFFSET)
+					& USART_MR_PAR_MASK)
+			| (((uint32_t)config->stopBits << USART_MR_NBSTOP_OFFSET)
+					& USART_MR_NBSTOP_MASK);
+
+	if (config->charLength == Usart_CharLength_9)
+		mr |= USART_MR_MODE9_MASK;
+	else
+		mr |= ((uint32_t)config->charLength << USART_MR_CHRL_OFFSET)
+				& USART_MR_CHRL_MASK;
+
+	if (config->isTestModeEnabled)
+		mr |= (USART_MR_CHMODE_LOCAL_LOOPBACK_VALUE
+				<< USART_MR_CHMODE_OFFSET);
+
+	if (baudRateInfo->isOversampling8x)
+		mr |= USART_MR_OVER_MASK;
+
+	return mr;
+}
+
+bool
+Usart_setConfig(Usart *const usart, const Usart_Config *const config,
+		int *const errCode)
+{
+	Usart_BaudRateInfo baudRateInfo;
+	if (!Usart_calculateBaudRate(config->baudRate, config->baudRateClkSrc,
+			    config->baudRateClkFreq, &baudRateInfo, errCode))
+		return false;
+
+	usart->reg->cr = USART_CR_RXDIS_MASK | USART_CR_TXDIS_MASK;
+
+	usart->reg->mr = encodeMode(config, &baudRateInfo);
+	usart->reg->brgr = (((uint32_t)baudRateInfo.clockDivisor
+					    << USART_BRGR_CD_OFFSET)
+					   & USART_BRGR_CD_MASK)
+			| (((uint32_t)baudRateInfo.fractionalPart
+					   << USART_BRGR_FP_OFFSET)
+					& USART_BRGR_FP_MASK);
+	usart->reg->rtor = (config->rxTimeout << USART_RTOR_TO_OFFSET)
+			& USART_RTOR_TO_MASK;
+
+	if (config->isTxEnabled)
+		usart->reg->cr = USART_CR_TXEN_MASK;
+
+	if (config->isRxEnabled)
+		usart->reg->cr = USART_CR_RXEN_MASK;
+
+	usart->config = *config;
+
+	return true;
+}
+
+void
+Usart_getConfig(const Usart *const usart, Usart_Config *const config)
+{
+	// There is no way to get the status of TX/RX from the device registers,
+	// so the configuration is stored in the descriptor, as in Uart.
+	*config = usart->config;
+
+	const uint32_t mr = usart->reg->mr;
+
+	config->isTestModeEnabled =
+			(((mr & USART_MR_CHMODE_MASK) >> USART_MR_CHMODE_OFFSET)
+					== USART_MR_CHMODE_LOCAL_LOOPBACK_VALUE);
+	config->isHardwareHandshakingEnabled =
+			(((mr & USART_MR_USART_MODE_MASK)
+					 >> USART_MR_USART_MODE_OFFSET)
+					== USART_MR_USART_MODE_HW_HANDSHAKING_VALUE);
+	config->parity = ((mr & USART_MR_PAR_MASK) >> USART_MR_PAR_OFFSET);
+	config->stopBits =
+			((mr & USART_MR_NBSTOP_MASK) >> USART_MR_NBSTOP_OFFSET);
+	if ((mr & USART_MR_MODE9_MASK) != 0u)
+		config->charLength = Usart_CharLength_9;
+	else
+		config->charLength = ((mr & USART_MR_CHRL_MASK)
+				>> USART_MR_CHRL_OFFSET);
+	config->baudRateClkSrc =
+			((mr & USART_MR_USCLKS_MASK) >> USART_MR_USCLKS_OFFSET);
+	config->rxTimeout = (usart->reg->rtor & USART_RTOR_TO_MASK)
+			>> USART_RTOR_TO_OFFSET;
+}
+
+bool
+Usart_write(Usart *const usart, const uint16_t data, uint32_t timeoutLimit,
+		int *const errCode)
+{
+	uint32_t timeout = timeoutLimit;
+	while (((usart->reg->csr & USART_CSR_TXRDY_MASK) == 0u)
+			&& (timeout > 0u))
+		timeout--;
+
+	if (timeout == 0u)
+		return returnError(errCode, Usart_ErrorCodes_Timeout);
+
+	usart->reg->thr = ((uint32_t)data << USART_THR_TXCHR_OFFSET)
+			& USART_THR_TXCHR_MASK;
+
+	return true;
+}
+
+bool
+Usart_read(Usart *const usart, uint16_t *const data, uint32_t timeoutLimit,
+		int *const errCode)
+{
+	uint32_t timeout = timeoutLimit;
+	while (((usart->reg->csr & USART_CSR_RXRDY_MASK) == 0u)
+			&& (timeout > 0u))
+		timeout--;
+
+	if (timeout == 0u)
+		return returnError(errCode, Usart_ErrorCodes_Timeout);
+
+	*data = (uint16_t)((usart->reg->rhr & USART_RHR_RXCHR_MASK)
+			>> USART_RHR_RXCHR_OFFSET);
+
+	return true;
+}
+
+bool
+Usart_writeAddress(Usart *const usart, const uint8_t address,
+		uint32_t timeoutLimit, int *const errCode)
+{
+	uint32_t timeout = timeoutLimit;
+	while (((usart->reg->csr & USART_CSR_TXRDY_MASK) == 0u)
+			&& (timeout > 0u))
+		timeout--;
+
+	if (timeout == 0u)
+		return returnError(errCode, Usart_ErrorCodes_Timeout);
+
+	// The next character written to THR is sent with the parity bit set.
+	usart->reg->cr = USART_CR_SENDA_MASK;
+	usart->reg->thr = address;
+
+	return true;
+}
+
+static inline bool
+isCharLength9(const Usart *const usart)
+{
+	return usart->config.charLength == Usart_CharLength_9;
+}
+
+bool
+Usart_writeAsync(Usart *const usart, ByteFifo *const fifo,
+		const Usart_TxHandler handler, int *const errCode)
+{
+	if (isCharLength9(usart))
+		return returnError(
+				errCode, Usart_ErrorCodes_UnsupportedCharLength);
+
+	disableTxIrq(usart);
+
+	usart->txFifo = fifo;
+	usart->txHandler = handler;
+
+	uint8_t data;
+	if ((usart->txFifo != NULL) && ByteFifo_pull(usart->txFifo, &data)) {
+		usart->reg->thr = data;
+		enableTxIrq(usart);
+	}
+
+	return true;
+}
+
+bool
+Usart_readAsync(Usart *const usart, ByteFifo *const fifo,
+		const Usart_RxHandler handler, int *const errCode)
+{
+	if (isCharLength9(usart))
+		return returnError(
+				errCode, Usart_ErrorCodes_UnsupportedCharLength);
+
+	disableRxIrq(usart);
+
+	usart->rxFifo = fifo;
+	usart->rxHandler = handler;
+
+	if (usart->rxFifo != NULL)
+		enableRxIrq(usart);
+
+	return true;
+}
+
+void
+Usart_readRxFifo(Usart *const usart, ByteFifo *const fifo)
+{
+	if (usart->rxFifo == NULL)
+		return;
+
+	while (!ByteFifo_isFull(fifo)) {
+		disableRxIrq(usart);
+
+		uint8_t data;
+		if (!ByteFifo_pull(usart->rxFifo, &data)) {
+			enableRxIrq(usart);
+			break;
+		}
+		enableRxIrq(usart);
+		ByteFifo_push(fifo, data);
+	}
+}
+
+void
+Usart_registerErrorHandler(Usart *const usart, const Usart_ErrorHandler handler)
+{
+	usart->reg->idr = USART_IDR_OVRE_MASK | USART_IDR_FRAME_MASK
+			| USART_IDR_PARE_MASK;
+
+	usart->errorHandler = handler;
+
+	if (usart->errorHandler.callback != NULL)
+		usart->reg->ier = USART_IER_OVRE_MASK | USART_IER_FRAME_MASK
+				| USART_IER_PARE_MASK;
+}
+
+void
+Usart_registerRxTimeoutHandler(
+		Usart *const usart, const Usart_RxTimeoutHandler handler)
+{
+	usart->reg->idr = USART_IDR_TIMEOUT_MASK;
+
+	usart->rxTimeoutHandler = handler;
+
+	if (usart->rxTimeoutHandler.callback != NULL) {
+		Usart_startRxTimeout(usart);
+		usart->reg->ier = USART_IER_TIMEOUT_MASK;
+	}
+}
+
+void
+Usart_startRxTimeout(Usart *const usart)
+{
+	usart->reg->cr = USART_CR_STTTO_MASK;
+}
+
+void
+Usart_restartRxTimeout(Usart *const usart)
+{
+	usart->reg->cr = USART_CR_RETTO_MASK;
+}
+
+void
+Usart_getDmaInterface(const Usart *const usart, Usart_DmaInterface *const dma)
+{
+	dma->rxDataRegister = &usart->reg->rhr;
+	dma->txDataRegister = &usart->reg->thr;
+
+	switch (usart->id) {
+	case Usart_Id_0:
+		dma->rxPeripheralId = USART0_XDMAC_RX_PERID;
+		dma->txPeripheralId = USART0_XDMAC_TX_PERID;
+		return;
+	case Usart_Id_1:
+		dma->rxPeripheralId = USART1_XDMAC_RX_PERID;
+		dma->txPeripheralId = USART1_XDMAC_TX_PERID;
+		return;
+	case Usart_Id_2:
+		dma->rxPeripheralId = USART2_XDMAC_RX_PERID;
+		dma->txPeripheralId = USART2_XDMAC_TX_PERID;
+		return;
+	}
+	assert(0 && "Incorrect USART id");
+}
+
+uint32_t
+Usart_getTxFifoCount(Usart *const usart)
+{
+	disableTxIrq(usart);
+
+	uint32_t count;
+	if (usart->txFifo == NULL)
+		count = 0;
+	else
+		count = (uint32_t)ByteFifo_getCount(usart->txFifo);
+
+	enableTxIrq(usart);
+
+	return count;
+}
+
+uint32_t
+Usart_getRxFifoCount(Usart *const usart)
+{
+	disableRxIrq(usart);
+
+	uint32_t count;
+	if (usart->rxFifo == NULL)
+		count = 0;
+	else
+		count = (uint32_t)ByteFifo_getCount(usart->rxFifo);
+
+	enableRxIrq(usart);
+
+	return count;
+}
+
+static inline bool
+isMultidropEnabled(const Usart *const usart)
+{
+	return usart->config.parity == Usart_Parity_Multidrop;
+}
+
+static inline bool
+handleRxInterrupt(Usart *const usart, const uint32_t csr, int *const errCode)
+{
+	const uint8_t data = (uint8_t)((usart->reg->rhr & USART_RHR_RXCHR_MASK)
+			>> USART_RHR_RXCHR_OFFSET);
+
+	// In multidrop mode the parity error flag marks an address character.
+	if (isMultidropEnabled(usart) && ((csr & USART_CSR_PARE_MASK) != 0u)) {
+		if (usart->rxHandler.addressCallback != NULL)
+			usart->rxHandler.addressCallback(
+					data, usart->rxHandler.addressArg);
+		return true;
+	}
+
+	if (usart->rxFifo == NULL) {
+		disableRxIrq(usart);
+		return true;
+	}
+
+	if (!ByteFifo_push(usart->rxFifo, data))
+		return returnError(errCode, Usart_ErrorCodes_Rx_Fifo_Full);
+
+	if ((usart->rxHandler.characterCallback != NULL)
+			&& (data == usart->rxHandler.targetCharacter))
+		usart->rxHandler.characterCallback(
+				usart->rxHandler.characterArg);
+	if ((usart->rxHandler.lengthCallback != NULL)
+			&& (ByteFifo_getCount(usart->rxFifo)
+					>= usart->rxHandler.targetLength))
+		usart->rxHandler.lengthCallback(usart->rxHandler.lengthArg);
+
+	return true;
+}
+
+static inline void
+handleTxInterrupt(Usart *const usart)
+{
+	uint8_t data = 0;
+	if (usart->txFifo == NULL) {
+		disableTxIrq(usart);
+	} else if (ByteFifo_pull(usart->txFifo, &data)) {
+		usart->reg->thr = data;
+	} else {
+		do {
+			if (usart->txHandler.callback != NULL)
+				usart->txFifo = usart->txHandler.callback(
+						usart->txHandler.arg);
+			else
+				usart->txFifo = NULL;
+
+			if (usart->txFifo == NULL) {
+				disableTxIrq(usart);
+				return;
+			}
+		} while (!ByteFifo_pull(usart->txFifo, &data));
+
+		usart->reg->thr = data;
+	}
+}
+
+static inline void
+handleRxTimeoutInterrupt(Usart *const usart)
+{
+	// Clear the flag and wait for the next character before restarting.
+	Usart_startRxTimeout(usart);
+
+	if (usart->rxTimeoutHandler.callback != NULL)
+		usart->rxTimeoutHandler.callback(usart->rxTimeoutHandler.arg);
+}
+
+static inline bool
+hasAnyErrorOccured(const Usart_ErrorFlags *const errFlags)
+{
+	return errFlags->hasFramingErrorOccurred
+			|| errFlags->hasOverrunOccurred
+			|| errFlags->hasParityErrorOccurred
+			|| errFlags->hasRxFifoFullErrorOccurred;
+}
+
+void
+Usart_handleInterrupt(Usart *const usart)
+{
+	int errorCode = 0;
+	Usart_ErrorFlags errorFlags = { false, false, false, false };
+
+	const uint32_t csr = usart->reg->csr;
+	const uint32_t status = csr & usart->reg->imr;
+	usart->reg->cr = USART_CR_RSTSTA_MASK;
+	if ((status & USART_CSR_RXRDY_MASK) != 0u) {
+		handleRxInterrupt(usart, csr, &errorCode);
+		if (errorCode == Usart_ErrorCodes_Rx_Fifo_Full)
+			errorFlags.hasRxFifoFullErrorOccurred = true;
+	}
+	if ((status & USART_CSR_TXEMPTY_MASK) != 0u)
+		handleTxInterrupt(usart);
+	if ((status & USART_CSR_TIMEOUT_MASK) != 0u)
+		handleRxTimeoutInterrupt(usart);
+
+	if (usart->errorHandler.callback == NULL)
+		return;
+
+	Usart_getLinkErrors(status, &errorFlags);
+	if (isMultidropEnabled(usart))
+		errorFlags.hasParityErrorOccurred = false;
+	if (hasAnyErrorOccured(&errorFlags))
+		usart->errorHandler.callback(errorFlags, usart->errorHandler.arg);
+}
+
+bool
+Usart_isTxEmpty(const Usart *const usart)
+{
+	return ((usart->reg->csr & USART_CSR_TXEMPTY_MASK) != 0u)
+			&& ((usart->reg->csr & USART_CSR_TXRDY_MASK) != 0u);
+}
+
+bool
+Usart_isDataAvailable(const Usart *const usart)
+{
+	return (usart->reg->csr & USART_CSR_RXRDY_MASK) != 0u;
+}
+
+void
+Usart_getLinkErrors(uint32_t statusRegister, Usart_ErrorFlags *const errFlags)
+{
+	errFlags->hasFramingErrorOccurred =
+			(statusRegister & USART_CSR_FRAME_MASK) != 0u;
+	errFlags->hasOverrunOccurred =
+			(statusRegister & USART_CSR_OVRE_MASK) != 0u;
+	errFlags->hasParityErrorOccurred =
+			(statusRegister & USART_CSR_PARE_MASK) != 0u;
+}
+
+uint32_t
+Usart_getStatusRegister(const Usart *const usart)
+{
+	const uint32_t status = usart->reg->csr;
+	usart->reg->cr = USART_CR_RSTSTA_MASK;
+	return status;
+}
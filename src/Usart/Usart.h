@@ -0,0 +1,405 @@
+/**@file
+ * This file is part of the ARM BSP for the Test Environment.
+ *
+ * @copyright 2020-2021 N7 Space Sp. z o.o.
+ *
+ * Test Environment was developed under a programme of,
+ * and funded by, the European Space Agency (the "ESA").
+ *
+ *
+ * Licensed under the ESA Public License (ESA-PL) Permissive,
+ * Version 2.3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://essr.esa.int/license/list
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/// \brief Usart hardware driver function prototypes and datatypes.
+
+/**
+ * @defgroup Usart Usart
+ * @ingroup Bsp
+ * @{
+ */
+
+#ifndef BSP_USART_H
+#define BSP_USART_H
+
+#include <Utils/ByteFifo.h>
+#include <Utils/Utils.h>
+
+#include "UsartRegisters.h"
+
+/// \brief Usart device identifiers.
+typedef enum {
+	Usart_Id_0 = 0, ///< Usart instance 0.
+	Usart_Id_1 = 1, ///< Usart instance 1.
+	Usart_Id_2 = 2, ///< Usart instance 2.
+} Usart_Id;
+
+/// \brief Usart baud rate clock sources.
+typedef enum {
+	Usart_BaudRateClk_PeripheralCk =
+			0, ///< Use peripheral clock for baud rate generation.
+	Usart_BaudRateClk_PeripheralCkDiv8 =
+			1, ///< Use peripheral clock divided by 8.
+	Usart_BaudRateClk_Pck = 2, ///< Use PCK for baud rate generation.
+} Usart_BaudRateClk;
+
+/// \brief Usart parity.
+typedef enum {
+	Usart_Parity_Even = 0, ///< Assume even parity bit.
+	Usart_Parity_Odd = 1, ///< Assume odd parity bit.
+	Usart_Parity_Space = 2, ///< Parity bit forced to 0.
+	Usart_Parity_Mark = 3, ///< Parity bit forced to 1.
+	Usart_Parity_None = 4, ///< Assume no parity bit.
+	/// \brief Multidrop mode, parity bit marks address characters.
+	Usart_Parity_Multidrop = 6,
+} Usart_Parity;
+
+/// \brief Usart character length.
+typedef enum {
+	Usart_CharLength_5 = 0, ///< 5-bit characters.
+	Usart_CharLength_6 = 1, ///< 6-bit characters.
+	Usart_CharLength_7 = 2, ///< 7-bit characters.
+	Usart_CharLength_8 = 3, ///< 8-bit characters.
+	Usart_CharLength_9 = 4, ///< 9-bit characters.
+} Usart_CharLength;
+
+/// \brief Usart number of stop bits.
+typedef enum {
+	Usart_StopBits_1 = 0, ///< 1 stop bit.
+	Usart_StopBits_1_5 = 1, ///< 1.5 stop bits.
+	Usart_StopBits_2 = 2, ///< 2 stop bits.
+} Usart_StopBits;
+
+/// \brief Usart configuration descriptor.
+typedef struct {
+	bool isTxEnabled; ///< Flag indicating whether the transmitter should be enabled.
+	bool isRxEnabled; ///< Flag indicating whether the receiver should be enabled.
+	bool isTestModeEnabled; ///< Flag indicating whether to enable local loopback mode.
+	/// \brief Flag indicating whether to enable RTS/CTS hardware handshaking.
+	bool isHardwareHandshakingEnabled;
+	Usart_Parity parity; ///< Indicator of used parity bit.
+	Usart_CharLength charLength; ///< Character length.
+	Usart_StopBits stopBits; ///< Number of stop bits.
+	uint32_t baudRate; ///< Target baud rate.
+	Usart_BaudRateClk
+			baudRateClkSrc; ///< Indicator of the baud rate clock source.
+	/// \brief Baud rate clock source frequency; for PeripheralCkDiv8 this is
+	/// the undivided peripheral clock frequency.
+	uint32_t baudRateClkFreq;
+	/// \brief Receiver time-out in bit periods, counted from the last
+	/// received character; 0 disables the time-out.
+	uint32_t rxTimeout;
+} Usart_Config;
+
+/// \brief Usart baud rate generator settings and the resulting accuracy.
+typedef struct {
+	Usart_BaudRateClk
+			baudRateClkSrc; ///< Indicator of the baud rate clock source.
+	uint32_t baudRateClkFreq; ///< Baud rate clock source frequency.
+	uint16_t clockDivisor; ///< Integer part of the clock divisor (CD).
+	uint8_t fractionalPart; ///< Fractional part of the divisor in 1/8 (FP).
+	bool isOversampling8x; ///< Flag indicating 8x instead of 16x oversampling.
+	uint32_t achievedBaudRate; ///< Baud rate resulting from the divisor.
+	int32_t errorPpm; ///< Baud rate error relative to the target in ppm.
+} Usart_BaudRateInfo;
+
+/// \brief A function serving as a callback called at the end of transmission.
+/// \returns ByteFifo from which data transmission should be continued.
+typedef ByteFifo *(*UsartTxEndCallback)(void *arg);
+
+/// \brief A descriptor of an end-of-transmission event handler.
+typedef struct {
+	UsartTxEndCallback callback; ///< Callback function.
+	void *arg; ///< Argument to the callback function.
+} Usart_TxHandler;
+
+/// \brief A function serving as a callback called upon a reception of a byte
+///        if the reception queue contains at least a number of bytes specified
+///        in the handler descriptor.
+typedef void (*UsartRxEndLengthCallback)(void *arg);
+/// \brief A function serving as a callback called upon a reception of a byte if
+/// byte matches
+///        a target specified in the handler descriptor.
+typedef void (*UsartRxEndCharacterCallback)(void *arg);
+/// \brief A function serving as a callback called upon a reception of an
+/// address character in multidrop mode.
+typedef void (*UsartRxAddressCallback)(uint8_t address, void *arg);
+
+/// \brief A descriptor of a byte reception event handler.
+typedef struct {
+	/// \brief Callback called when reception queue data count is greater
+	/// than or equal targetLength.
+	UsartRxEndLengthCallback lengthCallback;
+	/// \brief Callback called when a targetCharacter is received.
+	UsartRxEndCharacterCallback characterCallback;
+	/// \brief Callback called when an address character is received in
+	/// multidrop mode; address characters are not put into the queue.
+	UsartRxAddressCallback addressCallback;
+	/// \brief Argument for the length callback.
+	void *lengthArg;
+	/// \brief Argument for the character callback.
+	void *characterArg;
+	/// \brief Argument for the address callback.
+	void *addressArg;
+	/// \brief Target character, upon reception of which character callback
+	/// is called.
+	uint8_t targetCharacter;
+	/// \brief Target length of reception queue, upon reaching of which
+	/// length callback is called.
+	uint32_t targetLength;
+} Usart_RxHandler;
+
+/// \brief A function serving as a callback called upon expiration of the
+/// receiver time-out.
+typedef void (*UsartRxTimeoutCallback)(void *arg);
+
+/// \brief A descriptor of a receiver time-out handler.
+typedef struct {
+	UsartRxTimeoutCallback callback; ///< Callback function.
+	void *arg; ///< Argument to the callback function.
+} Usart_RxTimeoutHandler;
+
+/// \brief Usart error flags.
+typedef struct {
+	bool hasOverrunOccurred; // Hardware FIFO overrun detected.
+	bool hasFramingErrorOccurred; // Framing error detected.
+	bool hasParityErrorOccurred; // Parity error detected.
+	bool hasRxFifoFullErrorOccurred; // Rx FIFO full error detected.
+} Usart_ErrorFlags;
+
+/// \brief A function serving as a callback called upon detection of an error by
+/// hardware.
+typedef void (*UsartErrorCallback)(Usart_ErrorFlags errorFlags, void *arg);
+
+/// \brief A descriptor of an error handler.
+typedef struct {
+	UsartErrorCallback callback; ///< Callback function.
+	void *arg; ///< Argument to the callback function.
+} Usart_ErrorHandler;
+
+/// \brief Usart error codes.
+typedef enum {
+	Usart_ErrorCodes_Timeout =
+			1, ///< Timeout has occurred during a write/read operation.
+	Usart_ErrorCodes_Rx_Fifo_Full =
+			2, ///< Rx fifo was full during new byte reception
+	Usart_ErrorCodes_BaudRateOutOfRange =
+			3, ///< Baud rate cannot be generated from the given clock.
+	/// \brief 9-bit characters cannot be passed through the byte queues.
+	Usart_ErrorCodes_UnsupportedCharLength = 4,
+} Usart_ErrorCodes;
+
+/// \brief Usart XDMAC peripheral interface, used to transfer data with DMA
+/// instead of the byte queues.
+typedef struct {
+	volatile uint32_t *rxDataRegister; ///< Source address for reception.
+	volatile uint32_t *txDataRegister; ///< Destination address for transmission.
+	uint8_t rxPeripheralId; ///< XDMAC hardware request line for reception.
+	uint8_t txPeripheralId; ///< XDMAC hardware request line for transmission.
+} Usart_DmaInterface;
+
+/// \brief Usart device descriptor.
+typedef struct {
+	Usart_Id id; ///< Device identifier.
+	Usart_TxHandler txHandler; ///< End-of-transmission handler descriptor.
+	Usart_RxHandler rxHandler; ///< Reception handler descriptor.
+	Usart_RxTimeoutHandler rxTimeoutHandler; ///< Receiver time-out handler.
+	Usart_ErrorHandler errorHandler; ///< Error handler descriptor.
+	ByteFifo *txFifo; ///< Pointer to a transmission byte queue.
+	ByteFifo *rxFifo; ///< Pointer to a reception byte queue.
+	volatile Usart_Registers
+			*reg; ///< Pointer to memory-mapped device registers.
+	Usart_Config config; ///< Configuration descriptor.
+} Usart;
+
+/// \brief Performs a hardware startup procedure of an Usart device.
+/// \param [in] usart Usart device descriptor.
+void Usart_startup(Usart *const usart);
+
+/// \brief Performs a hardware shutdown procedure of an Usart device.
+/// \param [in] usart Usart device descriptor.
+void Usart_shutdown(Usart *const usart);
+
+/// \brief Intiializes a device descriptor for Usart.
+/// \param [in] id Usart device identifier.
+/// \param [out] usart Usart device descriptor.
+void Usart_init(const Usart_Id id, Usart *const usart);
+
+/// \brief Configures an Usart device based on a configuration descriptor.
+///        The device is left unchanged if the configuration is invalid.
+/// \param [in] usart Usart device descriptor.
+/// \param [in] config A configuration descriptor.
+/// \param [out] errCode An error code generated during the operation.
+/// \retval true The device was configured.
+/// \retval false The baud rate cannot be generated from the given clock.
+bool Usart_setConfig(Usart *const usart, const Usart_Config *const config,
+		int *const errCode);
+
+/// \brief Retrieves configuration of an Usart device.
+/// \param [in] usart Usart device descriptor.
+/// \param [out] config A configuration descriptor.
+void Usart_getConfig(const Usart *const usart, Usart_Config *const config);
+
+/// \brief Calculates the fractional baud rate generator settings closest to
+///        the target baud rate for the given clock source.
+/// \param [in] baudRate Target baud rate.
+/// \param [in] clkSrc Baud rate clock source.
+/// \param [in] clkFreq Baud rate clock source frequency.
+/// \param [out] info Calculated baud rate generator settings.
+/// \param [out] errCode An error code generated during the operation.
+/// \retval true The baud rate can be generated from the given clock.
+/// \retval false The required divisor is out of the supported range.
+bool Usart_calculateBaudRate(const uint32_t baudRate,
+		const Usart_BaudRateClk clkSrc, const uint32_t clkFreq,
+		Usart_BaudRateInfo *const info, int *const errCode);
+
+/// \brief Retrieves the baud rate generator settings of an Usart device,
+///        including the achieved baud rate and its error.
+/// \param [in] usart Usart device descriptor.
+/// \param [out] info Baud rate generator settings.
+void Usart_getBaudRateInfo(
+		const Usart *const usart, Usart_BaudRateInfo *const info);
+
+/// \brief Checks whenever RX has pending data.
+/// \param [in] usart Usart device descriptor.
+/// \retval true Data is available for reading.
+/// \retval false Data is not available for reading.
+bool Usart_isDataAvailable(const Usart *const usart);
+
+/// \brief Synchronously sends a character over Usart.
+/// \param [in] usart Usart device descriptor.
+/// \param [in] data Character to send; 9 bits are used in 9-bit mode.
+/// \param [in] timeoutLimit An arbitrary timeout value.
+/// \param [out] errCode An error code generated during the operation.
+/// \retval true Sending was successful.
+/// \retval false Sending timed out.
+bool Usart_write(Usart *const usart, const uint16_t data, uint32_t timeoutLimit,
+		int *const errCode);
+
+/// \brief Synchronously receives a character over Usart.
+/// \param [in] usart Usart device descriptor.
+/// \param [in] data Received character pointer; 9 bits are used in 9-bit
+///                  mode.
+/// \param [in] timeoutLimit An arbitrary timeout value.
+/// \param [out] errCode An error code generated during the operation.
+/// \retval true Reception was successful.
+/// \retval false Reception timed out.
+bool Usart_read(Usart *const usart, uint16_t *const data, uint32_t timeoutLimit,
+		int *const errCode);
+
+/// \brief Synchronously sends an address character in multidrop mode.
+/// \param [in] usart Usart device descriptor.
+/// \param [in] address Address character to send.
+/// \param [in] timeoutLimit An arbitrary timeout value.
+/// \param [out] errCode An error code generated during the operation.
+/// \retval true Sending was successful.
+/// \retval false Sending timed out.
+bool Usart_writeAddress(Usart *const usart, const uint8_t address,
+		uint32_t timeoutLimit, int *const errCode);
+
+/// \brief Asynchronously sends a series of bytes over Usart. Not available
+///        for 9-bit characters, which shall be sent with Usart_write.
+/// \param [in] usart Usart device descriptor.
+/// \param [in] fifo Pointer to the output byte queue.
+/// \param [in] handler Descriptor of the transmission handler.
+/// \param [out] errCode An error code generated during the operation.
+/// \retval true The transmission was started.
+/// \retval false The device is configured for 9-bit characters.
+bool Usart_writeAsync(Usart *const usart, ByteFifo *const fifo,
+		const Usart_TxHandler handler, int *const errCode);
+
+/// \brief Asynchronously receives a series of bytes over Usart. Not
+///        available for 9-bit characters, which shall be received with
+///        Usart_read.
+/// \param [in] usart Usart device descriptor.
+/// \param [in] fifo Pointer to the input byte queue.
+/// \param [in] handler Descriptor of the reception handler.
+/// \param [out] errCode An error code generated during the operation.
+/// \retval true The reception was started.
+/// \retval false The device is configured for 9-bit characters.
+bool Usart_readAsync(Usart *const usart, ByteFifo *const fifo,
+		const Usart_RxHandler handler, int *const errCode);
+
+/// \brief Checks if all bytes were sent.
+/// \param [in] usart Usart device descriptor.
+/// \retval true Tx queue is empty.
+/// \retval false Tx is busy.
+bool Usart_isTxEmpty(const Usart *const usart);
+
+/// \brief Pulls bytes stored in the reception queue.
+/// \param [in] usart Usart device descriptor.
+/// \param [out] fifo Byte queue into which bytes from the reception queue will
+/// be moved.
+void Usart_readRxFifo(Usart *const usart, ByteFifo *const fifo);
+
+/// \brief Gets transmission queue byte count.
+/// \param [in] usart Usart device descriptor.
+/// \returns The number of bytes in the sending queue, yet to be sent out.
+uint32_t Usart_getTxFifoCount(Usart *const usart);
+
+/// \brief Gets reception queue byte count.
+/// \param [in] usart Usart device descriptor.
+/// \returns The number of bytes in the reception queue, waiting to be pulled.
+uint32_t Usart_getRxFifoCount(Usart *const usart);
+
+/// \brief Registers a handler called upon detection of a hardware error.
+/// \param [in] usart Usart device descriptor.
+/// \param [in] handler Error handler descriptor.
+void Usart_registerErrorHandler(
+		Usart *const usart, const Usart_ErrorHandler handler);
+
+/// \brief Registers a handler called upon expiration of the receiver time-out
+///        and arms the time-out to start with the next received character.
+/// \param [in] usart Usart device descriptor.
+/// \param [in] handler Receiver time-out handler descriptor.
+void Usart_registerRxTimeoutHandler(
+		Usart *const usart, const Usart_RxTimeoutHandler handler);
+
+/// \brief Arms the receiver time-out to start with the next received
+///        character.
+/// \param [in] usart Usart device descriptor.
+void Usart_startRxTimeout(Usart *const usart);
+
+/// \brief Restarts the receiver time-out immediately, without waiting for a
+///        character.
+/// \param [in] usart Usart device descriptor.
+void Usart_restartRxTimeout(Usart *const usart);
+
+/// \brief Retrieves the XDMAC peripheral interface of an Usart device.
+///        When reception is done with DMA, Usart_readAsync shall not be used
+///        and the receiver time-out can be used to detect the end of a
+///        transfer of unknown length.
+/// \param [in] usart Usart device descriptor.
+/// \param [out] dma XDMAC peripheral interface descriptor.
+void Usart_getDmaInterface(
+		const Usart *const usart, Usart_DmaInterface *const dma);
+
+/// \brief Default interrupt handler for Usart devices.
+/// \param [in] usart Usart device descriptor.
+void Usart_handleInterrupt(Usart *const usart);
+
+/// \brief Checks status register for hardware errors.
+/// \param [in] statusRegister Usart status register value.
+/// \param [out] errFlags Pointer to error flag structure.
+void Usart_getLinkErrors(
+		uint32_t statusRegister, Usart_ErrorFlags *const errFlags);
+
+/// \brief Reads Usart device status register. Register flags are cleared upon
+/// read.
+/// \param [in] usart Usart device descriptor.
+/// \returns The status register value.
+uint32_t Usart_getStatusRegister(const Usart *const usart);
+
+#endif // BSP_USART_H
+
+/** @} */
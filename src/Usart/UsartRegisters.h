@@ -0,0 +1,251 @@
+/**@file
+ * This file is part of the ARM BSP for the Test Environment.
+ *
+ * @copyright 2020-2021 N7 Space Sp. z o.o.
+ *
+ * Test Environment was developed under a programme of,
+ * and funded by, the European Space Agency (the "ESA").
+ *
+ *
+ * Licensed under the ESA Public License (ESA-PL) Permissive,
+ * Version 2.3 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://essr.esa.int/license/list
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BSP_USART_REGISTERS_H
+#define BSP_USART_REGISTERS_H
+
+#include <stdint.h>
+
+/// \brief Structure representing USART control and status registers.
+typedef struct {
+	volatile uint32_t cr; ///< 0x00 Control Register
+	volatile uint32_t mr; ///< 0x04 Mode Register
+	volatile uint32_t ier; ///< 0x08 Interrupt Enable Register
+	volatile uint32_t idr; ///< 0x0C Interrupt Disable Register
+	volatile uint32_t imr; ///< 0x10 Interrupt Mask Register
+	volatile uint32_t csr; ///< 0x14 Channel Status Register
+	volatile uint32_t rhr; ///< 0x18 Receive Holding Register
+	volatile uint32_t thr; ///< 0x1C Transmit Holding Register
+	volatile uint32_t brgr; ///< 0x20 Baud Rate Generator Register
+	volatile uint32_t rtor; ///< 0x24 Receiver Timeout Register
+	volatile uint32_t ttgr; ///< 0x28 Transmitter Timeguard Register
+	volatile uint32_t reserved1[5]; ///< 0x2C - 0x3C Reserved
+	volatile uint32_t fidi; ///< 0x40 FI DI Ratio Register
+	volatile uint32_t ner; ///< 0x44 Number of Errors Register
+	volatile uint32_t reserved2; ///< 0x48 Reserved
+	volatile uint32_t ifr; ///< 0x4C IrDA Filter Register
+	volatile uint32_t man; ///< 0x50 Manchester Configuration Register
+	volatile uint32_t linmr; ///< 0x54 LIN Mode Register
+	volatile uint32_t linir; ///< 0x58 LIN Identifier Register
+	volatile uint32_t linbrr; ///< 0x5C LIN Baud Rate Register
+	volatile uint32_t lonmr; ///< 0x60 LON Mode Register
+	volatile uint32_t lonpr; ///< 0x64 LON Preamble Register
+	volatile uint32_t londl; ///< 0x68 LON Data Length Register
+	volatile uint32_t lonl2hdr; ///< 0x6C LON L2HDR Register
+	volatile uint32_t lonbl; ///< 0x70 LON Backlog Register
+	volatile uint32_t lonb1tx; ///< 0x74 LON Beta1 Tx Register
+	volatile uint32_t lonb1rx; ///< 0x78 LON Beta1 Rx Register
+	volatile uint32_t lonprio; ///< 0x7C LON Priority Register
+	volatile uint32_t idttx; ///< 0x80 LON IDT Tx Register
+	volatile uint32_t idtrx; ///< 0x84 LON IDT Rx Register
+	volatile uint32_t icdiff; ///< 0x88 IC DIFF Register
+	volatile uint32_t reserved3[22]; ///< 0x8C - 0xE0 Reserved
+	volatile uint32_t wpmr; ///< 0xE4 Write Protection Mode Register
+	volatile uint32_t wpsr; ///< 0xE8 Write Protection Status Register
+	volatile uint32_t reserved4[5]; ///< 0xEC - 0xFC Reserved
+} Usart_Registers;
+
+#define USART0_ADDRESS_BASE 0x40024000u
+#define USART1_ADDRESS_BASE 0x40028000u
+#define USART2_ADDRESS_BASE 0x4002C000u
+
+#define USART0_XDMAC_TX_PERID 7u
+#define USART0_XDMAC_RX_PERID 8u
+#define USART1_XDMAC_TX_PERID 9u
+#define USART1_XDMAC_RX_PERID 10u
+#define USART2_XDMAC_TX_PERID 11u
+#define USART2_XDMAC_RX_PERID 12u
+
+#define USART_CR_RSTRX_MASK 0x00000004u
+#define USART_CR_RSTRX_OFFSET 2u
+#define USART_CR_RSTTX_MASK 0x00000008u
+#define USART_CR_RSTTX_OFFSET 3u
+#define USART_CR_RXEN_MASK 0x00000010u
+#define USART_CR_RXEN_OFFSET 4u
+#define USART_CR_RXDIS_MASK 0x00000020u
+#define USART_CR_RXDIS_OFFSET 5u
+#define USART_CR_TXEN_MASK 0x00000040u
+#define USART_CR_TXEN_OFFSET 6u
+#define USART_CR_TXDIS_MASK 0x00000080u
+#define USART_CR_TXDIS_OFFSET 7u
+#define USART_CR_RSTSTA_MASK 0x00000100u
+#define USART_CR_RSTSTA_OFFSET 8u
+#define USART_CR_STTBRK_MASK 0x00000200u
+#define USART_CR_STTBRK_OFFSET 9u
+#define USART_CR_STPBRK_MASK 0x00000400u
+#define USART_CR_STPBRK_OFFSET 10u
+#define USART_CR_STTTO_MASK 0x00000800u
+#define USART_CR_STTTO_OFFSET 11u
+#define USART_CR_SENDA_MASK 0x00001000u
+#define USART_CR_SENDA_OFFSET 12u
+#define USART_CR_RSTIT_MASK 0x00002000u
+#define USART_CR_RSTIT_OFFSET 13u
+#define USART_CR_RSTNACK_MASK 0x00004000u
+#define USART_CR_RSTNACK_OFFSET 14u
+#define USART_CR_RETTO_MASK 0x00008000u
+#define USART_CR_RETTO_OFFSET 15u
+#define USART_CR_RTSEN_MASK 0x00040000u
+#define USART_CR_RTSEN_OFFSET 18u
+#define USART_CR_RTSDIS_MASK 0x00080000u
+#define USART_CR_RTSDIS_OFFSET 19u
+
+#define USART_MR_USART_MODE_MASK 0x0000000Fu
+#define USART_MR_USART_MODE_OFFSET 0u
+#define USART_MR_USART_MODE_NORMAL_VALUE 0x0u
+#define USART_MR_USART_MODE_HW_HANDSHAKING_VALUE 0x2u
+#define USART_MR_USCLKS_MASK 0x00000030u
+#define USART_MR_USCLKS_OFFSET 4u
+#define USART_MR_CHRL_MASK 0x000000C0u
+#define USART_MR_CHRL_OFFSET 6u
+#define USART_MR_SYNC_MASK 0x00000100u
+#define USART_MR_SYNC_OFFSET 8u
+#define USART_MR_PAR_MASK 0x00000E00u
+#define USART_MR_PAR_OFFSET 9u
+#define USART_MR_NBSTOP_MASK 0x00003000u
+#define USART_MR_NBSTOP_OFFSET 12u
+#define USART_MR_CHMODE_MASK 0x0000C000u
+#define USART_MR_CHMODE_OFFSET 14u
+#define USART_MR_CHMODE_LOCAL_LOOPBACK_VALUE 2u
+#define USART_MR_MSBF_MASK 0x00010000u
+#define USART_MR_MSBF_OFFSET 16u
+#define USART_MR_MODE9_MASK 0x00020000u
+#define USART_MR_MODE9_OFFSET 17u
+#define USART_MR_CLKO_MASK 0x00040000u
+#define USART_MR_CLKO_OFFSET 18u
+#define USART_MR_OVER_MASK 0x00080000u
+#define USART_MR_OVER_OFFSET 19u
+#define USART_MR_INACK_MASK 0x00100000u
+#define USART_MR_INACK_OFFSET 20u
+#define USART_MR_DSNACK_MASK 0x00200000u
+#define USART_MR_DSNACK_OFFSET 21u
+#define USART_MR_VAR_SYNC_MASK 0x00400000u
+#define USART_MR_VAR_SYNC_OFFSET 22u
+#define USART_MR_INVDATA_MASK 0x00800000u
+#define USART_MR_INVDATA_OFFSET 23u
+#define USART_MR_MAX_ITERATION_MASK 0x07000000u
+#define USART_MR_MAX_ITERATION_OFFSET 24u
+#define USART_MR_FILTER_MASK 0x10000000u
+#define USART_MR_FILTER_OFFSET 28u
+#define USART_MR_MAN_MASK 0x20000000u
+#define USART_MR_MAN_OFFSET 29u
+#define USART_MR_MODSYNC_MASK 0x40000000u
+#define USART_MR_MODSYNC_OFFSET 30u
+#define USART_MR_ONEBIT_MASK 0x80000000u
+#define USART_MR_ONEBIT_OFFSET 31u
+
+#define USART_IER_RXRDY_MASK 0x00000001u
+#define USART_IER_RXRDY_OFFSET 0u
+#define USART_IER_TXRDY_MASK 0x00000002u
+#define USART_IER_TXRDY_OFFSET 1u
+#define USART_IER_RXBRK_MASK 0x00000004u
+#define USART_IER_RXBRK_OFFSET 2u
+#define USART_IER_OVRE_MASK 0x00000020u
+#define USART_IER_OVRE_OFFSET 5u
+#define USART_IER_FRAME_MASK 0x00000040u
+#define USART_IER_FRAME_OFFSET 6u
+#define USART_IER_PARE_MASK 0x00000080u
+#define USART_IER_PARE_OFFSET 7u
+#define USART_IER_TIMEOUT_MASK 0x00000100u
+#define USART_IER_TIMEOUT_OFFSET 8u
+#define USART_IER_TXEMPTY_MASK 0x00000200u
+#define USART_IER_TXEMPTY_OFFSET 9u
+#define USART_IER_CTSIC_MASK 0x00080000u
+#define USART_IER_CTSIC_OFFSET 19u
+
+#define USART_IDR_RXRDY_MASK 0x00000001u
+#define USART_IDR_RXRDY_OFFSET 0u
+#define USART_IDR_TXRDY_MASK 0x00000002u
+#define USART_IDR_TXRDY_OFFSET 1u
+#define USART_IDR_RXBRK_MASK 0x00000004u
+#define USART_IDR_RXBRK_OFFSET 2u
+#define USART_IDR_OVRE_MASK 0x00000020u
+#define USART_IDR_OVRE_OFFSET 5u
+#define USART_IDR_FRAME_MASK 0x00000040u
+#define USART_IDR_FRAME_OFFSET 6u
+#define USART_IDR_PARE_MASK 0x00000080u
+#define USART_IDR_PARE_OFFSET 7u
+#define USART_IDR_TIMEOUT_MASK 0x00000100u
+#define USART_IDR_TIMEOUT_OFFSET 8u
+#define USART_IDR_TXEMPTY_MASK 0x00000200u
+#define USART_IDR_TXEMPTY_OFFSET 9u
+#define USART_IDR_CTSIC_MASK 0x00080000u
+#define USART_IDR_CTSIC_OFFSET 19u
+
+#define USART_IMR_RXRDY_MASK 0x00000001u
+#define USART_IMR_RXRDY_OFFSET 0u
+#define USART_IMR_TXRDY_MASK 0x00000002u
+#define USART_IMR_TXRDY_OFFSET 1u
+#define USART_IMR_RXBRK_MASK 0x00000004u
+#define USART_IMR_RXBRK_OFFSET 2u
+#define USART_IMR_OVRE_MASK 0x00000020u
+#define USART_IMR_OVRE_OFFSET 5u
+#define USART_IMR_FRAME_MASK 0x00000040u
+#define USART_IMR_FRAME_OFFSET 6u
+#define USART_IMR_PARE_MASK 0x00000080u
+#define USART_IMR_PARE_OFFSET 7u
+#define USART_IMR_TIMEOUT_MASK 0x00000100u
+#define USART_IMR_TIMEOUT_OFFSET 8u
+#define USART_IMR_TXEMPTY_MASK 0x00000200u
+#define USART_IMR_TXEMPTY_OFFSET 9u
+#define USART_IMR_CTSIC_MASK 0x00080000u
+#define USART_IMR_CTSIC_OFFSET 19u
+
+#define USART_CSR_RXRDY_MASK 0x00000001u
+#define USART_CSR_RXRDY_OFFSET 0u
+#define USART_CSR_TXRDY_MASK 0x00000002u
+#define USART_CSR_TXRDY_OFFSET 1u
+#define USART_CSR_RXBRK_MASK 0x00000004u
+#define USART_CSR_RXBRK_OFFSET 2u
+#define USART_CSR_OVRE_MASK 0x00000020u
+#define USART_CSR_OVRE_OFFSET 5u
+#define USART_CSR_FRAME_MASK 0x00000040u
+#define USART_CSR_FRAME_OFFSET 6u
+#define USART_CSR_PARE_MASK 0x00000080u
+#define USART_CSR_PARE_OFFSET 7u
+#define USART_CSR_TIMEOUT_MASK 0x00000100u
+#define USART_CSR_TIMEOUT_OFFSET 8u
+#define USART_CSR_TXEMPTY_MASK 0x00000200u
+#define USART_CSR_TXEMPTY_OFFSET 9u
+#define USART_CSR_CTSIC_MASK 0x00080000u
+#define USART_CSR_CTSIC_OFFSET 19u
+#define USART_CSR_CTS_MASK 0x00800000u
+#define USART_CSR_CTS_OFFSET 23u
+
+#define USART_RHR_RXCHR_MASK 0x000001FFu
+#define USART_RHR_RXCHR_OFFSET 0u
+
+#define USART_THR_TXCHR_MASK 0x000001FFu
+#define USART_THR_TXCHR_OFFSET 0u
+
+#define USART_BRGR_CD_MASK 0x0000FFFFu
+#define USART_BRGR_CD_OFFSET 0u
+#define USART_BRGR_FP_MASK 0x00070000u
+#define USART_BRGR_FP_OFFSET 16u
+
+#define USART_RTOR_TO_MASK 0x0001FFFFu
+#define USART_RTOR_TO_OFFSET 0u
+
+#define USART_TTGR_TG_MASK 0x000000FFu
+#define USART_TTGR_TG_OFFSET 0u
+
+#endif // BSP_USART_REGISTERS_H
@@ -0,0 +1,139 @@
+#!/usr/bin/env python3
+#
+# This file is part of the ARM BSP for the Test Environment.
+#
+# @copyright 2020-2021 N7 Space Sp. z o.o.
+#
+# Test Environment was developed under a programme of,
+# and funded by, the European Space Agency (the "ESA").
+#
+#
+# Licensed under the ESA Public License (ESA-PL) Permissive,
+# Version 2.3 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     https://essr.esa.int/license/list
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Extracts gcov data files from the captured output of a coverage run.
+
+Usage: coverage_decode.py <captured stream> [<output root>]
+
+Every file dumped by Stubs starts with a ">>>path" line, followed by an
+encoding tag line ("@hex", "@base64" or "@raw", with an optional "+rle"
+suffix) and ends with a "<<<" line. Dumps without a tag line are decoded as
+legacy hex, ending at the next ">>>" line or the end of the coverage result.
+Files are written under the output root (current directory by default),
+keeping their target paths.
+"""
+
+import base64
+import os
+import sys
+
+BEGIN_MARKER = b"\n>>>"
+END_MARKER = b"\n<<<\n"
+RESULT_END_MARKER = b"\n>> COVERAGE RESULT - END"
+
+
+def expand_zero_runs(data):
+    output = bytearray()
+    position = 0
+    while position < len(data):
+        byte = data[position]
+        if byte == 0:
+            output.extend(bytes(data[position + 1]))
+            position += 2
+        else:
+            output.append(byte)
+            position += 1
+    return bytes(output)
+
+
+def decode_text(payload, encoding):
+    text = b"".join(payload.split())
+    if encoding == "base64":
+        return base64.b64decode(text)
+    return bytes.fromhex(text.decode("ascii"))
+
+
+def decode_raw(stream, position):
+    data = bytearray()
+    while True:
+        length = stream[position]
+        position += 1
+        if length == 0:
+            break
+        data.extend(stream[position:position + length])
+        position += length
+    end = stream.index(END_MARKER, position)
+    return bytes(data), end + len(END_MARKER)
+
+
+def find_legacy_end(stream, position):
+    ends = [stream.find(marker, position)
+            for marker in (BEGIN_MARKER, RESULT_END_MARKER)]
+    ends = [end for end in ends if end >= 0]
+    return min(ends) if ends else len(stream)
+
+
+def parse_tag(stream, position):
+    if stream[position:position + 1] != b"@":
+        return None, False, position
+    end = stream.index(b"\n", position)
+    encoding, _, compression = stream[position + 1:end].decode().partition("+")
+    return encoding, compression == "rle", end + 1
+
+
+def decode_files(stream):
+    position = 0
+    while True:
+        begin = stream.find(BEGIN_MARKER, position)
+        if begin < 0:
+            return
+        name_end = stream.index(b"\n", begin + len(BEGIN_MARKER))
+        name = stream[begin + len(BEGIN_MARKER):name_end].decode()
+        encoding, is_compressed, position = parse_tag(stream, name_end + 1)
+
+        if encoding is None:
+            end = find_legacy_end(stream, position)
+            data = decode_text(stream[position:end], "hex")
+            position = end
+        elif encoding == "raw":
+            data, position = decode_raw(stream, position)
+        else:
+            end = stream.index(END_MARKER, position)
+            data = decode_text(stream[position:end], encoding)
+            position = end + len(END_MARKER)
+
+        if is_compressed:
+            data = expand_zero_runs(data)
+        yield name, data
+
+
+def main(argv):
+    if len(argv) not in (2, 3):
+        sys.stderr.write(__doc__)
+        return 1
+
+    output_root = argv[2] if len(argv) == 3 else "."
+    with open(argv[1], "rb") as stream_file:
+        stream = stream_file.read()
+
+    for name, data in decode_files(stream):
+        path = os.path.join(output_root, name.lstrip("/"))
+        os.makedirs(os.path.dirname(path) or ".", exist_ok=True)
+        with open(path, "wb") as output:
+            output.write(data)
+        print("{}: {} bytes".format(path, len(data)))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
@@ -0,0 +1,129 @@
+#!/usr/bin/env python3
+#
+# This file is part of the ARM BSP for the Test Environment.
+#
+# @copyright 2020-2021 N7 Space Sp. z o.o.
+#
+# Test Environment was developed under a programme of,
+# and funded by, the European Space Agency (the "ESA").
+#
+#
+# Licensed under the ESA Public License (ESA-PL) Permissive,
+# Version 2.3 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     https://essr.esa.int/license/list
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Streams the SDRAM stdout ring of a running target through OpenOCD.
+
+Usage: sdram_log_reader.py [<ring address> [<host> [<port>]]]
+
+Requires a target built with USE_SDRAM_IO and LOW_LEVEL_IO_SDRAM_RING, and
+OpenOCD with its Tcl RPC server enabled (port 6666 by default). The ring
+address defaults to the start of the SDRAM (sdramMemory_begin). Bytes
+overwritten before they could be read are reported as a gap.
+"""
+
+import socket
+import struct
+import sys
+import time
+
+RING_MAGIC = 0x474F4C53
+HEADER_SIZE = 16
+DEFAULT_ADDRESS = 0x70000000
+POLL_PERIOD = 0.05
+MAX_READ = 4096
+TCL_TERMINATOR = b"\x1a"
+
+
+class OpenOcd:
+    def __init__(self, host, port):
+        self.socket = socket.create_connection((host, port))
+
+    def command(self, command):
+        self.socket.sendall(command.encode() + TCL_TERMINATOR)
+        response = b""
+        while not response.endswith(TCL_TERMINATOR):
+            response += self.socket.recv(4096)
+        return response[:-1].decode()
+
+    def read_words(self, address, count):
+        response = self.command("read_memory 0x{:x} 32 {}".format(address, count))
+        return [int(word, 0) for word in response.split()]
+
+    def read_bytes(self, address, count):
+        response = self.command("read_memory 0x{:x} 8 {}".format(address, count))
+        return bytes(int(byte, 0) for byte in response.split())
+
+
+def read_header(ocd, address):
+    magic, sequence, capacity, _ = ocd.read_words(address, 4)
+    if magic != RING_MAGIC:
+        return None, None
+    return sequence, capacity
+
+
+def read_ring(ocd, address, capacity, start, count):
+    data = b""
+    while count > 0:
+        offset = start % capacity
+        chunk = min(count, capacity - offset, MAX_READ)
+        data += ocd.read_bytes(address + HEADER_SIZE + offset, chunk)
+        start += chunk
+        count -= chunk
+    return data
+
+
+def follow(ocd, address):
+    position = None
+    while True:
+        sequence, capacity = read_header(ocd, address)
+        if sequence is None:
+            time.sleep(POLL_PERIOD)
+            continue
+        if position is None or sequence < position:
+            position = max(0, sequence - capacity)
+
+        if sequence - position > capacity:
+            lost = sequence - capacity - position
+            sys.stdout.write("\n[... {} bytes lost ...]\n".format(lost))
+            position = sequence - capacity
+
+        if sequence > position:
+            data = read_ring(ocd, address, capacity, position,
+                             sequence - position)
+            newest, _ = read_header(ocd, address)
+            if newest is None or newest < sequence:
+                # The target was reset while the data was being read.
+                position = None
+                continue
+            # Discard bytes overwritten while they were being read.
+            overwritten = max(0, newest - capacity - position)
+            sys.stdout.write(data[overwritten:].decode("utf-8", "replace"))
+            sys.stdout.flush()
+            position = sequence
+        else:
+            time.sleep(POLL_PERIOD)
+
+
+def main(argv):
+    address = int(argv[1], 0) if len(argv) > 1 else DEFAULT_ADDRESS
+    host = argv[2] if len(argv) > 2 else "localhost"
+    port = int(argv[3]) if len(argv) > 3 else 6666
+    try:
+        follow(OpenOcd(host, port), address)
+    except KeyboardInterrupt:
+        pass
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
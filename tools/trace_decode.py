@@ -0,0 +1,143 @@
+#!/usr/bin/env python3
+#
+# This file is part of the ARM BSP for the Test Environment.
+#
+# @copyright 2020-2021 N7 Space Sp. z o.o.
+#
+# Test Environment was developed under a programme of,
+# and funded by, the European Space Agency (the "ESA").
+#
+#
+# Licensed under the ESA Public License (ESA-PL) Permissive,
+# Version 2.3 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     https://essr.esa.int/license/list
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Decodes binary trace records produced by the Trace module.
+
+Usage: trace_decode.py <application.elf> [<captured stream>]
+
+The format strings are read from the .traceFormats section of the ELF file.
+The stream (stdin if not given) is the raw output of the low-level IO, in
+which every record is a TRACE_RECORD_SYNC_BYTE followed by little-endian
+32-bit words: header (format ID << 3 | argument count), DWT cycle count
+timestamp and the arguments. Bytes outside records are passed through, so
+text written with printf remains readable.
+"""
+
+import re
+import struct
+import sys
+
+SECTION_NAME = b".traceFormats"
+SYNC_BYTE = 0x1E
+ARG_COUNT_BITS = 3
+ARG_COUNT_MASK = 0x7
+MAX_ARGS = 4
+HEADER_WORDS = 2
+
+CONVERSION = re.compile(r"%([-+ #0]*\d*(?:\.\d+)?)(hh|h|ll|l|z|t|j)?([diuxXoc%s])")
+
+
+def read_formats(elf_path):
+    with open(elf_path, "rb") as elf:
+        data = elf.read()
+    if data[:4] != b"\x7fELF" or data[4] != 1:
+        raise ValueError("expected a 32-bit ELF file")
+
+    (shoff,) = struct.unpack_from("<I", data, 0x20)
+    shentsize, shnum, shstrndx = struct.unpack_from("<HHH", data, 0x2E)
+
+    def section(index):
+        name, _, _, _, offset, size = struct.unpack_from(
+            "<IIIIII", data, shoff + index * shentsize)
+        return name, offset, size
+
+    _, strtab_offset, _ = section(shstrndx)
+    for index in range(shnum):
+        name, offset, size = section(index)
+        end = data.index(b"\0", strtab_offset + name)
+        if data[strtab_offset + name:end] == SECTION_NAME:
+            return data[offset:offset + size]
+    raise ValueError("no {} section found".format(SECTION_NAME.decode()))
+
+
+def format_string(formats, format_id):
+    end = formats.index(b"\0", format_id)
+    return formats[format_id:end].decode("utf-8", "replace")
+
+
+def apply_format(fmt, args):
+    values = iter(args)
+
+    def substitute(match):
+        flags, _, conversion = match.groups()
+        if conversion == "%":
+            return "%"
+        value = next(values, 0)
+        if conversion == "s":
+            return "<0x{:08x}>".format(value)
+        if conversion in "di" and value & 0x80000000:
+            value -= 1 << 32
+        if conversion == "u":
+            conversion = "d"
+        return ("%" + flags + conversion) % value
+
+    return CONVERSION.sub(substitute, fmt)
+
+
+def decode(formats, stream, out):
+    position = 0
+    while position < len(stream):
+        byte = stream[position]
+        if byte != SYNC_BYTE or position + 1 + 4 * HEADER_WORDS > len(stream):
+            out.write(chr(byte))
+            position += 1
+            continue
+
+        (header,) = struct.unpack_from("<I", stream, position + 1)
+        arg_count = header & ARG_COUNT_MASK
+        format_id = header >> ARG_COUNT_BITS
+        record_end = position + 1 + 4 * (HEADER_WORDS + arg_count)
+        if arg_count > MAX_ARGS or format_id >= len(formats) \
+                or record_end > len(stream):
+            out.write(chr(byte))
+            position += 1
+            continue
+
+        words = struct.unpack_from(
+            "<{}I".format(HEADER_WORDS + arg_count), stream, position + 1)
+        timestamp = words[1]
+        text = apply_format(format_string(formats, format_id), words[2:])
+        out.write("[{:10d}] {}".format(timestamp, text))
+        if not text.endswith("\n"):
+            out.write("\n")
+        position = record_end
+
+
+def main(argv):
+    if len(argv) not in (2, 3):
+        sys.stderr.write(__doc__)
+        return 1
+
+    formats = read_formats(argv[1])
+    if len(argv) == 3:
+        with open(argv[2], "rb") as stream_file:
+            stream = stream_file.read()
+    else:
+        stream = sys.stdin.buffer.read()
+
+    decode(formats, stream, sys.stdout)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))